@@ -0,0 +1,78 @@
+#include "canvas.h"
+#include "math3d.h"
+#include "renderer.h"
+#include "lighting.h"
+#include "soccerball.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+// Lit solid soccer ball rendered entirely from SoA vertex streams
+int main() {
+    int width = 400, height = 400;
+
+    vec3_t* vertices = NULL;
+    int vertex_count = 0;
+    int (*edges)[2] = NULL;
+    int edge_count = 0;
+    int (*triangles)[3] = NULL;
+    int triangle_count = 0;
+    generate_soccer_ball(&vertices, &vertex_count, &edges, &edge_count);
+    generate_soccer_ball_triangles(&triangles, &triangle_count);
+
+    // The ball is centred on the origin, so normalized positions double as normals
+    vec3_stream_t* positions = vec3_stream_create(vertex_count);
+    vec3_stream_t* world = vec3_stream_create(vertex_count);
+    vec3_stream_t* normals = vec3_stream_create(vertex_count);
+    float* intensity = malloc(vertex_count * sizeof(float));
+    canvas_t* canvas = canvas_create(width, height);
+    float* depth = canvas ? depth_buffer_create(canvas) : NULL;
+    light_system_t* lights = create_light_system(2);
+    if (!positions || !world || !normals || !intensity || !depth || !lights) {
+        fprintf(stderr, "Failed to allocate lighting demo\n");
+        return 1;
+    }
+    vec3_stream_load_vec3(positions, vertices);
+
+    // Model is a pure rotation, so the same matrix carries positions and normals
+    mat4_t model = mat4_rotate_xyz(0.3f, 0.5f, 0.0f);
+    mat4_t view = mat4_translate(0.0f, 0.0f, -4.0f);
+    float aspect_ratio = (float)width / height;
+    mat4_t proj = mat4_frustum_asymmetric(-aspect_ratio, aspect_ratio, -1.0f, 1.0f, 1.0f, 10.0f);
+    mat4_transform_stream(model, positions, world);
+    mat4_transform_stream(model, positions, normals);
+    for (int i = 0; i < vertex_count; ++i) {
+        float len = sqrtf(normals->x[i] * normals->x[i] + normals->y[i] * normals->y[i] +
+                          normals->z[i] * normals->z[i]);
+        if (len > 0.0f) {
+            normals->x[i] /= len;
+            normals->y[i] /= len;
+            normals->z[i] /= len;
+        }
+    }
+
+    vec3_t key = { .x = 3.0f, .y = 3.0f, .z = 4.0f };
+    vec3_t fill = { .x = -4.0f, .y = -1.0f, .z = 2.0f };
+    vec3_t white = { .x = 1.0f, .y = 1.0f, .z = 1.0f };
+    vec3_t none = { .x = 0.0f };
+    add_light(lights, key, none, 0.9f, white);
+    add_light(lights, fill, none, 0.3f, white);
+    calculate_vertex_lighting_stream(world, normals, lights, intensity);
+
+    render_solid_stream(canvas, positions, triangles, triangle_count, model, view, proj, intensity, CULL_BACK, depth);
+    canvas_save_ppm(canvas, "lighting.pgm");
+    canvas_save_png(canvas, "lighting.png", 6);
+    printf("Lit soccer ball saved to lighting.pgm and lighting.png\n");
+
+    free_light_system(lights);
+    free(depth);
+    canvas_destroy(canvas);
+    free(intensity);
+    vec3_stream_destroy(normals);
+    vec3_stream_destroy(world);
+    vec3_stream_destroy(positions);
+    free(triangles);
+    free(edges);
+    free(vertices);
+    return 0;
+}
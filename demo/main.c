@@ -32,6 +32,7 @@ int main() {
     
     // Save or display canvas somehow
     canvas_save_ppm(canvas, "clock_demo.ppm");
+    canvas_save_png(canvas, "clock.png", 6);
     
     // Clean up
     canvas_destroy(canvas);
@@ -0,0 +1,23 @@
+#include "mesh.h"
+#include <stdio.h>
+
+// Converts a Wavefront OBJ file into the memory-mapped .t3m mesh format
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        fprintf(stderr, "Usage: %s input.obj output.t3m\n", argv[0]);
+        return 1;
+    }
+
+    if (mesh_convert_obj(argv[1], argv[2]) != 0) {
+        return 1;
+    }
+
+    mesh_t* mesh = mesh_open(argv[2]);
+    if (!mesh) {
+        return 1;
+    }
+    printf("%s: %d vertices, %d triangles, %d edges\n",
+           argv[2], mesh->vertex_count, mesh->triangle_count, mesh->edge_count);
+    mesh_close(mesh);
+    return 0;
+}
@@ -1,9 +1,14 @@
 #include "canvas.h"
 #include "math3d.h"
 #include "renderer.h"
+#include "soccerball.h"
+#include "frame_writer.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
  
 int main(){
     int width=400, height=400;
@@ -29,22 +34,44 @@ int main(){
     
     render_wireframe(soccer_canvas, soccer_vertices, soccer_vertex_count, soccer_edges, soccer_edge_count,soccer_model, soccer_view, soccer_proj);
     
+    // Frames are written in the background while the next ones render
+    frame_writer_t* writer = frame_writer_create(width, height, 4, 2, FRAME_FORMAT_PGM, 0);
+    if (!writer) {
+        fprintf(stderr, "Failed to create frame writer\n");
+        return 1;
+    }
+
     char filename[64];
     for (int frame = 0; frame < 60; ++frame) {
         float angle = frame * (2.0f * M_PI / 60);  // One full rotation
         mat4_t soccer_model = mat4_rotate_xyz(0.0f, angle, 0.0f);  // Y-axis rotation
 
-        canvas_t* frame_canvas = canvas_create(width, height);
+        canvas_t* frame_canvas = frame_writer_acquire(writer);
         render_wireframe(frame_canvas, soccer_vertices, soccer_vertex_count,
                         soccer_edges, soccer_edge_count, soccer_model, soccer_view, soccer_proj);
 
         sprintf(filename, "soccer_%03d.pgm", frame);
-        canvas_save_ppm(frame_canvas, filename);
-        canvas_destroy(frame_canvas);
+        if (frame_writer_submit(writer, frame_canvas, filename) != 0) break;
     }
+    frame_writer_destroy(writer);
     canvas_save_ppm(soccer_canvas, "soccer.pgm");
     printf("Soccer ball saved to soccer.pgm\n");
 
+    // Solid version of the same mesh with flat shading and depth test
+    int (*soccer_triangles)[3] = NULL;
+    int soccer_triangle_count = 0;
+    generate_soccer_ball_triangles(&soccer_triangles, &soccer_triangle_count);
+
+    canvas_t* solid_canvas = canvas_create(width, height);
+    float* depth = depth_buffer_create(solid_canvas);
+    render_solid(solid_canvas, soccer_vertices, soccer_vertex_count, soccer_triangles, soccer_triangle_count,
+                 mat4_rotate_xyz(0.3f, 0.5f, 0.0f), soccer_view, soccer_proj, NULL, CULL_BACK, depth);
+    canvas_save_ppm(solid_canvas, "soccer_solid.pgm");
+    printf("Solid soccer ball saved to soccer_solid.pgm\n");
+
+    free(depth);
+    canvas_destroy(solid_canvas);
+    free(soccer_triangles);
     free(soccer_vertices);
     free(soccer_edges);
     canvas_destroy(soccer_canvas);
@@ -52,5 +79,3 @@ int main(){
 
     return 0;
 }
-
-#endif
\ No newline at end of file
@@ -23,6 +23,8 @@ animation_system_t* create_animation_system(int max_curves);
 void add_bezier_curve(animation_system_t *system, bezier_curve_t curve);
 void update_animation_system(animation_system_t *system, float delta_time);
 vec3_t get_bezier_position(bezier_curve_t *curve, float time);
+// Stateless sampling at a curve-local time; wraps looping curves instead of clamping
+vec3_t sample_bezier_curve(const bezier_curve_t *curve, float local_time);
 void free_animation_system(animation_system_t *system);
 
 #endif
@@ -1,21 +1,49 @@
 #ifndef CANVAS_H
 #define CANVAS_H
 
+#include "viewport.h"
+
 typedef struct {
     int width, height;
     float **pixels;
+    viewport_mask_t *viewport;  // Circular viewport mask, built on first use
 } canvas_t;
 
+// Pixel rectangle, e.g. the dirty region of a layer
+typedef struct {
+    int x, y, width, height;
+} canvas_rect_t;
+
 // Canvas management functions
 canvas_t* canvas_create(int width, int height);
 void canvas_destroy(canvas_t* canvas);
 void canvas_clear(canvas_t* canvas);    // Clear canvas to black/zero
 void canvas_save_ppm(canvas_t* canvas, const char* filename);
+// Saves as 8-bit grayscale PNG; level 0 = stored, 1-9 = faster..smaller (6 is a good default)
+void canvas_save_png(canvas_t* canvas, const char* filename, int level);
 
 // Drawing functions
 // Uses bilinear filtering to spread intensity across nearby 4 pixels
 void set_pixel_f(canvas_t* canvas, float x, float y, float intensity);
-// Uses DDA algorithm with thickness support
+// Uses DDA algorithm for thin lines; thickness > 1 fills an antialiased capsule row by row
 void draw_line_f(canvas_t* canvas, float x0, float y0, float x1, float y1, float thickness);
+// Same as draw_line_f but only writes pixels inside the mask (NULL = whole canvas).
+// Nothing is drawn if the mask's dimensions differ from the canvas.
+void draw_line_f_masked(canvas_t* canvas, const viewport_mask_t* mask,
+                        float x0, float y0, float x1, float y1, float thickness);
+// The canvas's circular viewport (see viewport_mask_circle), built once and kept
+// until canvas_destroy; NULL if it could not be allocated
+const viewport_mask_t* canvas_viewport_mask(canvas_t* canvas);
+
+// Compositing functions
+// Whole-row SIMD kernels. region limits the work to a dirty rectangle (NULL = whole
+// canvas) and is clipped to both canvases; src and dst are addressed at the same coordinates.
+void canvas_add(canvas_t* dst, const canvas_t* src, const canvas_rect_t* region);   // dst += src
+void canvas_max(canvas_t* dst, const canvas_t* src, const canvas_rect_t* region);   // dst = max(dst, src)
+void canvas_blend(canvas_t* dst, const canvas_t* src, float alpha, const canvas_rect_t* region); // dst = lerp(dst, src, alpha)
+void canvas_scale(canvas_t* canvas, float factor, const canvas_rect_t* region);     // Decay for motion trails
+// Copies all of src into dst with its top-left corner at (dx, dy), clipped to dst;
+// dst may be src (scrolling in place)
+void canvas_blit(canvas_t* dst, const canvas_t* src, int dx, int dy);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,87 @@
+#ifndef FIXED3D_H
+#define FIXED3D_H
+
+#include <stdint.h>
+#include "math3d.h"
+#include "viewport.h"
+
+// Opt-in fixed-point pipeline for cores without a fast FPU.
+// Q16.16 matrices and vertices, integer projection to screen space and an
+// integer line rasterizer writing into an 8-bit canvas. Floats are only used
+// to convert inputs once (fmat4_from_mat4 / fvec3_from_vec3), which can be
+// done offline.
+//
+// Error bound vs. the float path: inputs are rounded to 2^-16, and every
+// matrix-vector product accumulates in 64 bits before a single rounding, so
+// each transformed component is within 4 * 2^-16 * (1 + max|coordinate|).
+// For scenes with coordinates and matrix entries of magnitude <= 8 and clip
+// w >= 1 (anything behind the near plane at z = -1 or further), projected NDC
+// coordinates are within 1e-3 of the float result, i.e. under 0.5 px on
+// canvases up to 1000 px wide. Screen endpoints therefore differ from the
+// float path by at most one pixel, from the final truncation.
+// Values must stay below 32768 in magnitude.
+
+typedef int32_t fix16_t;
+
+#define FIX16_SHIFT 16
+#define FIX16_ONE   (1 << FIX16_SHIFT)
+
+// Vertices with clip w below FIX16_NEAR_W (1/256) are treated as behind the
+// camera, and screen coordinates are limited to +-FIX16_SCREEN_LIMIT so the
+// projection and the line walk cannot overflow
+#define FIX16_NEAR_W        (FIX16_ONE >> 8)
+#define FIX16_SCREEN_LIMIT  (1 << 27)
+
+typedef struct {
+    fix16_t x, y, z;
+} fvec3_t;
+
+typedef struct {
+    fix16_t m[16];  // Column-major, same layout as mat4_t: m[col * 4 + row]
+} fmat4_t;
+
+// 8-bit grayscale canvas, one contiguous row-major buffer
+typedef struct {
+    int width, height;
+    uint8_t *pixels;
+    viewport_mask_t *viewport;  // Circular viewport mask, built on first use
+} canvas8_t;
+
+// Conversions
+fix16_t fix16_from_float(float f);
+float fix16_to_float(fix16_t v);
+fix16_t fix16_mul(fix16_t a, fix16_t b);
+fvec3_t fvec3_from_vec3(vec3_t v);
+fmat4_t fmat4_from_mat4(mat4_t m);
+
+// Matrix operations (result = A * B, transform includes the perspective divide)
+fmat4_t fmat4_multiply(fmat4_t A, fmat4_t B);
+fvec3_t fmat4_transform_fvec3(fmat4_t mat, fvec3_t v);
+
+// Projects through mvp to integer pixel coordinates; returns 0 if the vertex is behind
+// the near epsilon (w < FIX16_NEAR_W) or lands beyond FIX16_SCREEN_LIMIT
+int fproject_to_screen(fmat4_t mvp, fvec3_t v, int width, int height, int *sx, int *sy);
+
+// 8-bit canvas management
+canvas8_t* canvas8_create(int width, int height);
+void canvas8_destroy(canvas8_t *canvas);
+void canvas8_clear(canvas8_t *canvas);
+void canvas8_save_pgm(canvas8_t *canvas, const char *filename);
+// Cached circular viewport, like canvas_viewport_mask
+const viewport_mask_t* canvas8_viewport_mask(canvas8_t *canvas);
+
+// Integer Bresenham line, saturating add of intensity at each pixel. The walk is
+// clipped to the canvas up front, so long off-screen segments cost nothing;
+// endpoints beyond FIX16_SCREEN_LIMIT are rejected.
+void canvas8_draw_line(canvas8_t *canvas, int x0, int y0, int x1, int y1, uint8_t intensity);
+// Same, but only pixels inside the mask are written (NULL = whole canvas) and
+// the walk is clipped to the mask's bounding box.
+// Nothing is drawn if the mask's dimensions differ from the canvas.
+void canvas8_draw_line_masked(canvas8_t *canvas, const viewport_mask_t *mask,
+                              int x0, int y0, int x1, int y1, uint8_t intensity);
+
+// Fixed-point counterpart of render_wireframe (mvp = projection * view * model)
+void render_wireframe_fixed(canvas8_t *canvas, const fvec3_t *vertices, int vertex_count,
+                            int (*edges)[2], int edge_count, fmat4_t mvp);
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef FRAME_WRITER_H
+#define FRAME_WRITER_H
+
+#include <pthread.h>
+#include "canvas.h"
+
+// Asynchronous output stage: the render thread acquires a canvas from a fixed
+// pool, draws into it and submits it with a filename. Background writer
+// threads encode and save submitted frames, clear the canvases and return them
+// to the pool. When every canvas is queued or being written, acquire blocks,
+// which bounds memory and throttles rendering to the speed of the disk.
+
+typedef enum {
+    FRAME_FORMAT_PGM,   // canvas_save_ppm (ASCII P2)
+    FRAME_FORMAT_PNG    // canvas_save_png at png_level
+} frame_format_t;
+
+typedef struct {
+    canvas_t *canvas;
+    char filename[256];
+} frame_job_t;
+
+typedef struct {
+    canvas_t **pool;            // Every canvas owned by the writer
+    canvas_t **free_canvases;   // Stack of canvases ready to be acquired
+    unsigned char *acquired;    // Per pool slot: handed out and not yet submitted
+    int pool_size, free_count;
+
+    frame_job_t *queue;         // Ring buffer of submitted frames (pool_size slots)
+    int queue_head, queue_count;
+
+    pthread_t *threads;
+    int thread_count;
+    pthread_mutex_t lock;
+    pthread_cond_t frame_ready;     // Signalled on submit and shutdown
+    pthread_cond_t canvas_free;     // Signalled when a written canvas returns to the pool
+
+    frame_format_t format;
+    int png_level;
+    int stopping;
+} frame_writer_t;
+
+frame_writer_t* frame_writer_create(int width, int height, int pool_size, int writer_threads,
+                                    frame_format_t format, int png_level);
+// Writes every queued frame, stops the writer threads and frees all canvases
+void frame_writer_destroy(frame_writer_t *writer);
+
+// Returns a cleared canvas from the pool, blocking until one is free
+canvas_t* frame_writer_acquire(frame_writer_t *writer);
+// Queues an acquired canvas to be saved as filename; the writer takes it back afterwards.
+// Returns 0, or -1 without queueing anything if the canvas is not from this pool, was
+// already submitted, or filename is longer than 255 characters (the canvas stays acquired).
+int frame_writer_submit(frame_writer_t *writer, canvas_t *canvas, const char *filename);
+
+#endif
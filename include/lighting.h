@@ -23,4 +23,8 @@ light_system_t* create_light_system(int max_lights);
 void add_light(light_system_t *system, vec3_t position, vec3_t direction, float intensity, vec3_t color);
 void free_light_system(light_system_t *system);
 
+// Per-vertex Lambert intensity over SoA streams (e.g. render_solid's vertex_intensity)
+void calculate_vertex_lighting_stream(const vec3_stream_t *positions, const vec3_stream_t *normals,
+                                      light_system_t *lights, float *out_intensity);
+
 #endif
\ No newline at end of file
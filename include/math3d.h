@@ -1,7 +1,6 @@
 #ifndef MATH3D_H
 #define MATH3D_H
 #include <math.h>
-#include "soccerball.h"
 
 
 // 3D Vector (Cartesian + Spherical)
@@ -19,6 +18,19 @@ vec3_t vec3_normalize_fast(vec3_t v);
 vec3_t vec3_slerp(vec3_t a, vec3_t b, float t);
 
 
+// Vertex stream (structure of arrays): x[i], y[i], z[i] for i < count
+// Batch kernels take streams so every loop runs over contiguous floats
+
+typedef struct {
+    float *x, *y, *z;
+    int count;
+} vec3_stream_t;
+
+vec3_stream_t* vec3_stream_create(int count);
+void vec3_stream_destroy(vec3_stream_t* stream);
+void vec3_stream_load_vec3(vec3_stream_t* stream, const vec3_t* vertices);   // count vertices in
+
+
 // 4x4 Matrix (Column-major)
 
 typedef struct {
@@ -35,6 +47,9 @@ mat4_t mat4_frustum_asymmetric(float left, float right, float bottom, float top,
 mat4_t mat4_multiply(mat4_t A, mat4_t B);   // Matrix multiply: result = A * B
 
 vec3_t mat4_transform_vec3(mat4_t mat, vec3_t v);   // Transform vector by matrix
+// Batch transform of in into out (same count); includes the perspective divide.
+// in and out must be different streams: the arrays are treated as non-overlapping.
+void mat4_transform_stream(mat4_t mat, const vec3_stream_t* in, vec3_stream_t* out);
 
 #endif
 
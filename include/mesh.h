@@ -0,0 +1,54 @@
+#ifndef MESH_H
+#define MESH_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Binary mesh file (.t3m), little-endian, every section 4-byte aligned:
+//   mesh_header_t
+//   float    positions[vertex_count * 3]    x, y, z packed
+//   uint32_t triangles[triangle_count * 3]
+//   uint32_t edges[edge_count * 2]          unique, sorted, (a < b)
+// Files are memory-mapped and used in place; nothing is parsed or copied.
+
+#define MESH_MAGIC   "T3DM"
+#define MESH_VERSION 1
+
+typedef struct {
+    char magic[4];
+    uint32_t version;
+    uint32_t vertex_count;
+    uint32_t triangle_count;
+    uint32_t edge_count;
+    uint32_t reserved[3];   // Pads the header to 32 bytes
+} mesh_header_t;
+
+typedef struct {
+    const float *positions;         // vertex_count * 3 floats
+    const uint32_t (*triangles)[3];
+    const uint32_t (*edges)[2];
+    int vertex_count;
+    int triangle_count;
+    int edge_count;
+
+    void *mapping;                  // Whole file mapping
+    size_t mapping_size;
+} mesh_t;
+
+// Maps a .t3m file read-only; returns NULL if it is missing or its header and
+// size do not check out. Only the header is read, so open cost does not grow
+// with the mesh.
+mesh_t* mesh_open(const char *filename);
+// Reads every triangle and edge index and checks it against vertex_count;
+// returns 0, or -1 if any is out of range. mesh_convert_obj only writes valid
+// indices, so this is for files from elsewhere before they are rendered.
+int mesh_validate(const mesh_t *mesh);
+void mesh_close(mesh_t *mesh);
+
+// Streams a Wavefront OBJ file into .t3m using constant memory.
+// v lines become positions, f polygons are fan-triangulated, and polygon
+// outlines plus l polylines become edges (deduplicated in the output file).
+// Returns 0 on success, -1 on failure.
+int mesh_convert_obj(const char *obj_filename, const char *mesh_filename);
+
+#endif
@@ -3,16 +3,77 @@
 
 #include "canvas.h"
 #include "math3d.h"
+#include "mesh.h"
 
 // Project a vertex from world space to screen space
 vec3_t project_vertex(vec3_t vertex, mat4_t model, mat4_t view, mat4_t projection);
 
+// Project a whole vertex stream to screen space (mvp = projection * view * model);
+// in and screen must be different streams of the same count
+void project_stream(canvas_t* canvas, mat4_t mvp, const vec3_stream_t* in, vec3_stream_t* screen);
+
 // Check if pixel is inside circular viewport
 int clip_to_circular_viewport(canvas_t* canvas, int x, int y);
 
-// Draw a 3D object as a wireframe
+// Draw a 3D object as a wireframe, clipped exactly to the circular viewport
 void render_wireframe(canvas_t* canvas, vec3_t* vertices, int vertex_count, 
                      int (*edges)[2], int edge_count,
                      mat4_t model, mat4_t view, mat4_t projection);
 
+// Same as render_wireframe but clipped to any viewport mask (NULL = whole canvas);
+// the mask must have the canvas's dimensions or nothing is drawn
+void render_wireframe_masked(canvas_t* canvas, const viewport_mask_t* mask, vec3_t* vertices, int vertex_count,
+                             int (*edges)[2], int edge_count,
+                             mat4_t model, mat4_t view, mat4_t projection);
+
+// Same as render_wireframe_masked for a vertex stream; each vertex is projected once
+void render_wireframe_stream(canvas_t* canvas, const viewport_mask_t* mask, const vec3_stream_t* vertices,
+                             int (*edges)[2], int edge_count,
+                             mat4_t model, mat4_t view, mat4_t projection);
+
+// One camera of a multi-view render; every view must have its own canvas
+typedef struct {
+    mat4_t view;
+    mat4_t projection;
+    canvas_t* canvas;
+} render_view_t;
+
+// Draw the same wireframe into several views. World-space vertices are computed
+// once and the per-view projection and rasterization run on up to thread_count threads.
+// Each view matches render_wireframe. Returns 0, or -1 (nothing drawn) if scratch memory
+// could not be allocated.
+int render_wireframe_multi(vec3_t* vertices, int vertex_count, int (*edges)[2], int edge_count,
+                           mat4_t model, const render_view_t* views, int view_count, int thread_count);
+
+// Draw a memory-mapped binary mesh (see mesh.h) as a wireframe in the circular viewport
+void render_wireframe_mesh(canvas_t* canvas, const mesh_t* mesh, mat4_t model, mat4_t view, mat4_t projection);
+
+// Depth buffer of canvas width*height floats, cleared to +infinity (free() when done)
+float* depth_buffer_create(canvas_t* canvas);
+void depth_buffer_clear(canvas_t* canvas, float* depth);
+
+// Which triangles render_solid skips. Front faces are wound counter-clockwise
+// as seen from the camera (outward normals by the right-hand rule).
+typedef enum {
+    CULL_NONE,      // Draw both sides; closed meshes then need the depth buffer
+    CULL_BACK       // Skip triangles wound clockwise on screen
+} cull_mode_t;
+
+// Draw a 3D object as filled triangles
+// vertex_intensity: per-vertex intensity interpolated across each triangle, or NULL
+//                   for flat shading by how directly each face points at the camera
+//                   (faces turned away shade to 0)
+// cull: CULL_BACK for closed, consistently wound meshes; CULL_NONE otherwise
+// depth_buffer: from depth_buffer_create to enable the depth test, or NULL to draw in order
+void render_solid(canvas_t* canvas, vec3_t* vertices, int vertex_count,
+                  int (*triangles)[3], int triangle_count,
+                  mat4_t model, mat4_t view, mat4_t projection,
+                  const float* vertex_intensity, cull_mode_t cull, float* depth_buffer);
+
+// Same as render_solid for a vertex stream (vertex_intensity indexed like the stream)
+void render_solid_stream(canvas_t* canvas, const vec3_stream_t* vertices,
+                         int (*triangles)[3], int triangle_count,
+                         mat4_t model, mat4_t view, mat4_t projection,
+                         const float* vertex_intensity, cull_mode_t cull, float* depth_buffer);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,88 @@
+#ifndef RUNLOOP_H
+#define RUNLOOP_H
+
+// Fixed-timestep run loop with frame pacing and budget control.
+// Simulation advances in fixed steps independent of the frame rate; rendering
+// gets the leftover fraction of a step for interpolation. When a frame takes
+// longer than the budget the loop lowers the quality level it passes to the
+// render callback, and raises it again after a run of comfortably fast frames.
+
+#define RUNLOOP_HISTOGRAM_BUCKETS 64    // 1 ms per bucket; the last one collects everything slower
+
+// Suggested meaning of the quality level handed to the render callback
+typedef enum {
+    RENDER_QUALITY_FULL = 0,
+    RENDER_QUALITY_NO_LIGHTING = 1,     // Skip lighting
+    RENDER_QUALITY_LOW_LOD = 2,         // Also drop to a lower mesh LOD
+    RENDER_QUALITY_MINIMAL = 3
+} render_quality_t;
+
+typedef struct {
+    double sim_step;            // Fixed simulation step in seconds
+    double frame_budget;        // Target frame time in seconds
+    int max_steps_per_frame;    // Catch-up limit; older backlog is dropped to bound latency
+    int max_quality_level;      // Worst quality the loop may degrade to
+    int recover_frames;         // Consecutive frames under 75% of budget before improving quality
+} runloop_config_t;
+
+typedef struct {
+    runloop_config_t config;
+    void (*update)(void *user, double dt);
+    void (*render)(void *user, double alpha, int quality);
+    void *user;
+
+    // Time source used by runloop_run: the monotonic clock and an absolute-deadline
+    // sleep by default, replaceable with runloop_set_clock (e.g. a simulated clock)
+    double (*now)(void *clock_user);
+    void (*sleep_until)(void *clock_user, double deadline);
+    void *clock_user;
+
+    double accumulator;         // Unsimulated time carried to the next frame
+    double sim_time;
+    int quality;
+    int fast_streak;
+    int running;
+
+    // Statistics
+    unsigned long frame_count;
+    unsigned long overrun_count;    // Frames over budget
+    unsigned long dropped_steps;    // Simulation steps skipped by the catch-up limit
+    unsigned long histogram[RUNLOOP_HISTOGRAM_BUCKETS];            // Work time per frame
+    double last_frame_time, worst_frame_time;
+    unsigned long interval_count;
+    unsigned long interval_histogram[RUNLOOP_HISTOGRAM_BUCKETS];   // Start-to-start time between frames
+    double last_interval, worst_interval;
+} runloop_t;
+
+// 60 Hz simulation, 60 fps budget, up to 4 catch-up steps, degrade to MINIMAL, recover after 30 frames
+runloop_config_t runloop_default_config(void);
+
+runloop_t* runloop_create(runloop_config_t config,
+                          void (*update)(void *user, double dt),
+                          void (*render)(void *user, double alpha, int quality),
+                          void *user);
+void runloop_destroy(runloop_t *loop);
+// Replaces the clock runloop_run reads and the sleep it paces with; times in seconds
+void runloop_set_clock(runloop_t *loop, double (*now)(void *clock_user),
+                       void (*sleep_until)(void *clock_user, double deadline), void *clock_user);
+
+// Runs paced frames until runloop_stop is called (e.g. from a callback) or max_frames (> 0) have run.
+// Frames start on a fixed schedule of frame_budget; after a stall longer than a frame the schedule restarts.
+void runloop_run(runloop_t *loop, int max_frames);
+void runloop_stop(runloop_t *loop);
+
+// Building blocks for callers that own their own timing (e.g. a vsync'd display):
+// advance by elapsed wall time and render once, then report how long the frame's
+// work took (drives quality) and the time since the previous frame started
+void runloop_frame(runloop_t *loop, double elapsed);
+void runloop_record_frame(runloop_t *loop, double frame_time);
+void runloop_record_interval(runloop_t *loop, double interval);
+
+// Histograms (counts per 1 ms bucket) and percentile estimates in seconds, of
+// per-frame work time and of the frame-to-frame interval the viewer sees
+const unsigned long* runloop_histogram(const runloop_t *loop, int *bucket_count);
+double runloop_frame_percentile(const runloop_t *loop, double percentile);
+const unsigned long* runloop_interval_histogram(const runloop_t *loop, int *bucket_count);
+double runloop_interval_percentile(const runloop_t *loop, double percentile);
+
+#endif
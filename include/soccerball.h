@@ -3,6 +3,8 @@
 
 #include "math3d.h"
 
-//void generate_soccer_ball(vec3_t** out_vertices, int* out_vertex_count, int (**out_edges)[2], int* out_edge_count);
+void generate_soccer_ball(vec3_t** out_vertices, int* out_vertex_count, int (**out_edges)[2], int* out_edge_count);
+// Triangulated faces indexing the same vertices as generate_soccer_ball
+void generate_soccer_ball_triangles(int (**out_triangles)[3], int* out_triangle_count);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,50 @@
+#ifndef TIMELINE_H
+#define TIMELINE_H
+
+#include "animation.h"
+
+// Event-driven scheduler for large, sparse curve sets.
+// Each curve is active on [start_time, end_time). Activation and deactivation
+// events live in a min-heap, so advancing the timeline only touches curves
+// whose state changes plus the currently active set.
+
+typedef struct {
+    bezier_curve_t curve;
+    float start_time, end_time;
+    int active_slot;    // Index into the active list, -1 while idle
+} timeline_entry_t;
+
+typedef struct {
+    float time;
+    int curve_id;
+    int activate;       // 1 = start of the interval, 0 = end
+} timeline_event_t;
+
+typedef struct {
+    timeline_entry_t *entries;
+    int count, capacity;
+    timeline_event_t *events;   // Binary min-heap ordered by time
+    int event_count, event_capacity;
+    int *active;                // Ids of currently active curves (unordered)
+    int active_count;
+    float current_time;
+} animation_timeline_t;
+
+animation_timeline_t* create_animation_timeline(int initial_capacity);
+void free_animation_timeline(animation_timeline_t *timeline);
+
+// Schedules a curve on [start_time, end_time); returns its id, or -1 on failure
+int timeline_add_curve(animation_timeline_t *timeline, bezier_curve_t curve, float start_time, float end_time);
+
+// Moves to absolute time t (must not decrease) and updates the active set
+void timeline_advance(animation_timeline_t *timeline, float time);
+void timeline_update(animation_timeline_t *timeline, float delta_time);
+
+// Ids of the curves active at the current time
+const int* timeline_active_curves(const animation_timeline_t *timeline, int *count);
+
+// Stateless position of a curve at absolute time t (independent of current_time).
+// Before start_time it holds the start position, from end_time on the end position.
+vec3_t timeline_sample(const animation_timeline_t *timeline, int curve_id, float time);
+
+#endif
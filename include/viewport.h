@@ -0,0 +1,31 @@
+#ifndef VIEWPORT_H
+#define VIEWPORT_H
+
+// Precomputed viewport mask: for every row, the inclusive [xmin, xmax] spans
+// that may be drawn. Rows are stored back to back (row_start[y] .. row_start[y+1]),
+// so circles and ellipses cost one span per row and arbitrary stencils as many
+// as they need. Rasterizers look spans up once per row instead of testing
+// every pixel against the shape.
+
+typedef struct {
+    int xmin, xmax;
+} span_t;
+
+typedef struct {
+    int width, height;
+    int *row_start;     // height + 1 offsets into spans
+    span_t *spans;
+    int xmin, ymin, xmax, ymax;     // Bounding box of all spans (xmin > xmax when empty)
+} viewport_mask_t;
+
+// Same circle as clip_to_circular_viewport: centred, radius min(width, height) / 2
+viewport_mask_t* viewport_mask_circle(int width, int height);
+// Axis-aligned ellipse; pixels with ((x-cx)/rx)^2 + ((y-cy)/ry)^2 <= 1 are inside
+viewport_mask_t* viewport_mask_ellipse(int width, int height, float cx, float cy, float rx, float ry);
+// Arbitrary shape from a width*height stencil, non-zero bytes are inside
+viewport_mask_t* viewport_mask_from_stencil(int width, int height, const unsigned char *stencil);
+void viewport_mask_destroy(viewport_mask_t *mask);
+
+int viewport_mask_contains(const viewport_mask_t *mask, int x, int y);
+
+#endif
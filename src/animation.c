@@ -64,6 +64,18 @@ vec3_t get_bezier_position(bezier_curve_t *curve, float time) {
     return vec3_bezier(curve->p0, curve->p1, curve->p2, curve->p3, t);
 }
 
+vec3_t sample_bezier_curve(const bezier_curve_t *curve, float local_time) {
+    if (curve->loop && curve->duration > 0.0f) {
+        local_time = fmodf(local_time, curve->duration);
+        if (local_time < 0.0f) local_time += curve->duration;
+    }
+    float t = curve->duration > 0.0f ? local_time / curve->duration : 1.0f;
+    if (t > 1.0f) t = 1.0f;
+    if (t < 0.0f) t = 0.0f;
+
+    return vec3_bezier(curve->p0, curve->p1, curve->p2, curve->p3, t);
+}
+
 void free_animation_system(animation_system_t *system) {
     free(system->curves);
     free(system);
@@ -74,6 +86,10 @@ void free_animation_system(animation_system_t *system) {
 // ============================================================================
 
 // Enhanced wireframe renderer with lighting
+// Needs the scene types (mesh_t with transform, camera_t, z_buffer_t) and the
+// lighting helpers, none of which exist in this tree yet. Fenced off so the
+// animation module builds; define ANIMATION_LIT_RENDERER once they land.
+#ifdef ANIMATION_LIT_RENDERER
 void render_wireframe_lit(canvas_t *canvas, mesh_t *mesh, camera_t *camera, 
                          light_system_t *lights, z_buffer_t *zbuffer) {
     // Create transformation matrices
@@ -122,3 +138,4 @@ void render_wireframe_lit(canvas_t *canvas, mesh_t *mesh, camera_t *camera,
     free(projected_vertices);
     free(world_vertices);
 }
+#endif
@@ -1,7 +1,9 @@
 #include <stdio.h>
 #include "canvas.h"
+#include "viewport.h"
 #include <math.h>
 #include <stdlib.h>
+#include <limits.h>
 
 canvas_t* canvas_create(int width, int height) {
     if(width <= 0 || height <= 0) return NULL;
@@ -11,6 +13,7 @@ canvas_t* canvas_create(int width, int height) {
 
     canvas->width = width;
     canvas->height = height;
+    canvas->viewport = NULL;
     
     // Allocate array of row pointers
     canvas->pixels = malloc(height * sizeof(float*));
@@ -40,9 +43,9 @@ canvas_t* canvas_create(int width, int height) {
 }
 
 void set_pixel_f(canvas_t* canvas, float x, float y, float intensity) {
-    int x0 = (int)floor(x);
+    int x0 = (int)floorf(x);
     int x1 = x0 + 1;
-    int y0 = (int)floor(y);
+    int y0 = (int)floorf(y);
     int y1 = y0 + 1;
 
     float fx = x - x0;
@@ -63,32 +66,295 @@ void set_pixel_f(canvas_t* canvas, float x, float y, float intensity) {
         canvas->pixels[y1][x1] += intensity * w11;
 }
 
-// Consider using integer DDA for better performance:
+// Solves lo <= a*x + b <= hi for x; returns 0 when no x satisfies it
+static int linear_interval(float a, float b, float lo, float hi, float* l, float* r) {
+    if(fabsf(a) < 1e-6f) {
+        if(b < lo || b > hi) return 0;
+        *l = -INFINITY;
+        *r = INFINITY;
+        return 1;
+    }
+    float t0 = (lo - b) / a;
+    float t1 = (hi - b) / a;
+    *l = t0 < t1 ? t0 : t1;
+    *r = t0 < t1 ? t1 : t0;
+    return 1;
+}
+
+// Horizontal extent of a capsule (segment swept by a disc of radius R) on row y.
+// The capsule is convex, so the union of the slab and the two end caps is one span.
+static int capsule_row_span(float x0, float y0, float x1, float y1, float R, float y, float* xl, float* xr) {
+    int found = 0;
+    float l = INFINITY, r = -INFINITY;
+
+    // End caps
+    float cx[2] = { x0, x1 }, cy[2] = { y0, y1 };
+    for(int i = 0; i < 2; i++) {
+        float d = y - cy[i];
+        if(d * d <= R * R) {
+            float half = sqrtf(R * R - d * d);
+            if(cx[i] - half < l) l = cx[i] - half;
+            if(cx[i] + half > r) r = cx[i] + half;
+            found = 1;
+        }
+    }
+
+    // Slab: perpendicular distance <= R and projection inside the segment
+    float dx = x1 - x0, dy = y1 - y0;
+    float len_sq = dx * dx + dy * dy;
+    if(len_sq > 1e-6f) {
+        float len = sqrtf(len_sq);
+        float pl, pr, tl, tr;
+        if(linear_interval(dy / len, -(y - y0) * dx / len - x0 * dy / len, -R, R, &pl, &pr) &&
+           linear_interval(dx / len_sq, ((y - y0) * dy - x0 * dx) / len_sq, 0.0f, 1.0f, &tl, &tr)) {
+            float sl = pl > tl ? pl : tl;
+            float sr = pr < tr ? pr : tr;
+            if(sl <= sr) {
+                if(sl < l) l = sl;
+                if(sr > r) r = sr;
+                found = 1;
+            }
+        }
+    }
+
+    *xl = l;
+    *xr = r;
+    return found;
+}
+
+static float segment_distance(float px, float py, float x0, float y0, float dx, float dy, float inv_len_sq) {
+    float t = ((px - x0) * dx + (py - y0) * dy) * inv_len_sq;
+    if(t < 0.0f) t = 0.0f;
+    if(t > 1.0f) t = 1.0f;
+    float ex = px - (x0 + t * dx);
+    float ey = py - (y0 + t * dy);
+    return sqrtf(ex * ex + ey * ey);
+}
+
+// Fills pixels a..b of one capsule row: [is, ie] is the fully covered interior,
+// everything else is rim and gets distance-based coverage
+static void capsule_run(float* row, int a, int b, int is, int ie, float y,
+                        float x0, float y0, float dx, float dy, float inv_len_sq, float outer) {
+    int left_end = b < is - 1 ? b : is - 1;
+    for(int x = a; x <= left_end; x++) {
+        float coverage = outer - segment_distance((float)x, y, x0, y0, dx, dy, inv_len_sq);
+        if(coverage > 0.0f) row[x] += coverage > 1.0f ? 1.0f : coverage;
+    }
+    int inner_start = a > is ? a : is;
+    int inner_end = b < ie ? b : ie;
+    for(int x = inner_start; x <= inner_end; x++) {
+        row[x] += 1.0f;
+    }
+    int right_start = a > ie + 1 ? a : ie + 1;
+    for(int x = right_start; x <= b; x++) {
+        float coverage = outer - segment_distance((float)x, y, x0, y0, dx, dy, inv_len_sq);
+        if(coverage > 0.0f) row[x] += coverage > 1.0f ? 1.0f : coverage;
+    }
+}
+
+// Rasterizes a thick line as an antialiased capsule, one span per row.
+// Interior pixels get full intensity without a distance test; only the
+// one-pixel rim around the edge evaluates coverage. With a mask, each row's
+// span is intersected with the mask's spans for that row.
+static void draw_capsule(canvas_t* canvas, const viewport_mask_t* mask, float x0, float y0, float x1, float y1, float radius) {
+    float outer = radius + 0.5f;
+    float inner = radius - 0.5f;
+    float dx = x1 - x0, dy = y1 - y0;
+    float len_sq = dx * dx + dy * dy;
+    float inv_len_sq = len_sq > 1e-6f ? 1.0f / len_sq : 0.0f;
+
+    int ymin = (int)ceilf((y0 < y1 ? y0 : y1) - outer);
+    int ymax = (int)floorf((y0 > y1 ? y0 : y1) + outer);
+    if(ymin < 0) ymin = 0;
+    if(ymax > canvas->height - 1) ymax = canvas->height - 1;
+
+    for(int y = ymin; y <= ymax; y++) {
+        float ol, or_;
+        if(!capsule_row_span(x0, y0, x1, y1, outer, (float)y, &ol, &or_)) continue;
+        int xs = (int)ceilf(ol);
+        int xe = (int)floorf(or_);
+        if(xs < 0) xs = 0;
+        if(xe > canvas->width - 1) xe = canvas->width - 1;
+        if(xs > xe) continue;
+
+        int is = xe + 1, ie = xe;  // Empty inner span by default
+        float il, ir;
+        if(inner > 0.0f && capsule_row_span(x0, y0, x1, y1, inner, (float)y, &il, &ir)) {
+            is = (int)ceilf(il);
+            ie = (int)floorf(ir);
+            if(is < xs) is = xs;
+            if(ie > xe) ie = xe;
+            if(is > ie) {
+                is = xe + 1;
+                ie = xe;
+            }
+        }
+
+        float* row = canvas->pixels[y];
+        if(!mask) {
+            capsule_run(row, xs, xe, is, ie, (float)y, x0, y0, dx, dy, inv_len_sq, outer);
+            continue;
+        }
+        for(int i = mask->row_start[y]; i < mask->row_start[y + 1]; i++) {
+            int a = mask->spans[i].xmin > xs ? mask->spans[i].xmin : xs;
+            int b = mask->spans[i].xmax < xe ? mask->spans[i].xmax : xe;
+            if(a <= b) capsule_run(row, a, b, is, ie, (float)y, x0, y0, dx, dy, inv_len_sq, outer);
+        }
+    }
+}
+
+// The mask spans of one row that overlap a line's run [lo, hi] on that row.
+// The usual single span is kept as a plain interval so the per-pixel test is
+// two compares; rows split into several spans keep the overlapping ones.
+typedef struct {
+    int xmin, xmax;         // The only overlapping span (empty when count == 0)
+    const span_t* spans;
+    int count;
+} row_clip_t;
+
+static int row_span_count(const viewport_mask_t* mask, int row) {
+    if(row < 0 || row >= mask->height) return 0;
+    return mask->row_start[row + 1] - mask->row_start[row];
+}
+
+static row_clip_t clip_row(const viewport_mask_t* mask, int row, int lo, int hi) {
+    row_clip_t clip = { 0, -1, NULL, 0 };
+    int n = row_span_count(mask, row);
+    if(n == 0) return clip;
+
+    // Spans are sorted left to right and disjoint
+    const span_t* spans = &mask->spans[mask->row_start[row]];
+    if(n == 1) {
+        if(spans[0].xmax < lo || spans[0].xmin > hi) return clip;
+        clip.xmin = spans[0].xmin;
+        clip.xmax = spans[0].xmax;
+        clip.spans = spans;
+        clip.count = 1;
+        return clip;
+    }
+    int first = 0;
+    while(first < n && spans[first].xmax < lo) first++;
+    int last = first;
+    while(last < n && spans[last].xmin <= hi) last++;
+
+    clip.spans = spans + first;
+    clip.count = last - first;
+    if(clip.count == 1) {
+        clip.xmin = clip.spans[0].xmin;
+        clip.xmax = clip.spans[0].xmax;
+    }
+    return clip;
+}
+
+// Narrows steps [*first, *last] of a DDA line to those whose splat can reach
+// [lo, hi) along one axis; one step of slack either side absorbs rounding
+static void trim_steps(float start, float inc, float lo, float hi, int* first, int* last) {
+    if(inc == 0.0f) {
+        if(start < lo || start >= hi) *last = *first - 1;
+        return;
+    }
+    float a = (lo - start) / inc;
+    float b = (hi - start) / inc;
+    float kmin = fminf(a, b) - 1.0f;
+    float kmax = fmaxf(a, b) + 1.0f;
+    if(kmin > *last || kmax < *first) {
+        *last = *first - 1;
+        return;
+    }
+    if(kmin > *first) *first = (int)kmin;
+    if(kmax < *last) *last = (int)kmax;
+}
+
+static int clip_contains(row_clip_t clip, int x) {
+    if(clip.count <= 1) return x >= clip.xmin && x <= clip.xmax;
+    for(int i = 0; i < clip.count; i++) {
+        if(x >= clip.spans[i].xmin && x <= clip.spans[i].xmax) return 1;
+    }
+    return 0;
+}
+
+// Thin lines use a DDA with bilinear splats; thicker lines are filled as capsules
 void draw_line_f(canvas_t* canvas, float x0, float y0, float x1, float y1, float thickness) {
+    draw_line_f_masked(canvas, NULL, x0, y0, x1, y1, thickness);
+}
+
+void draw_line_f_masked(canvas_t* canvas, const viewport_mask_t* mask,
+                        float x0, float y0, float x1, float y1, float thickness) {
+    // A mask of another size would index rows and columns the canvas does not have
+    if(mask && (mask->width != canvas->width || mask->height != canvas->height)) return;
+
+    if(thickness > 1.0f) {
+        draw_capsule(canvas, mask, x0, y0, x1, y1, thickness * 0.5f);
+        return;
+    }
+
     float dx = x1 - x0;
     float dy = y1 - y0;
     
-    int steps = (int)fmax(fabs(dx), fabs(dy));
-    if(steps == 0) {
-        set_pixel_f(canvas, x0, y0, 1.0f);
+    int steps = (int)fmaxf(fabsf(dx), fabsf(dy));
+    float x_inc = steps ? dx / steps : 0.0f;
+    float y_inc = steps ? dy / steps : 0.0f;
+
+    if(!mask) {
+        for(int i = 0; i <= steps; i++) {
+            set_pixel_f(canvas, x0 + i * x_inc, y0 + i * y_inc, 1.0f);
+        }
         return;
     }
-    
-    float x_inc = dx / steps;
-    float y_inc = dy / steps;
-    
-    for(int i = 0; i <= steps; i++) {
+
+    // Each row is clipped against the mask once, when the line reaches it. A row
+    // holding a single span (circles, ellipses) becomes one interval to compare
+    // against; on rows split into several spans, the run of columns the line can
+    // touch on that row is intersected with them so only the overlapping ones remain.
+    // Steps whose splat misses the mask's bounding box are skipped outright.
+    if(mask->xmin > mask->xmax) return;
+    int first = 0, last = steps;
+    trim_steps(x0, x_inc, mask->xmin - 1.0f, mask->xmax + 1.0f, &first, &last);
+    trim_steps(y0, y_inc, mask->ymin - 1.0f, mask->ymax + 1.0f, &first, &last);
+
+    float inv_y_step = y_inc != 0.0f ? 1.0f / fabsf(y_inc) : 0.0f;
+    int cached_row = INT_MIN;
+    row_clip_t top = { 0, -1, NULL, 0 }, bottom = { 0, -1, NULL, 0 };
+    for(int i = first; i <= last; i++) {
         float x = x0 + i * x_inc;
         float y = y0 + i * y_inc;
-        
-        // Simpler thickness implementation
-        int thick_pixels = (int)thickness;
-        for(int tx = -thick_pixels/2; tx <= thick_pixels/2; tx++) {
-            for(int ty = -thick_pixels/2; ty <= thick_pixels/2; ty++) {
-                set_pixel_f(canvas, x + tx, y + ty, 1.0f);
+        int ix = (int)floorf(x);
+        int iy = (int)floorf(y);
+        if(iy != cached_row) {
+            cached_row = iy;
+            top = clip_row(mask, iy, INT_MIN, INT_MAX);
+            bottom = clip_row(mask, iy + 1, INT_MIN, INT_MAX);
+            if(top.count > 1 || bottom.count > 1) {
+                // Steps left on this row, plus one for rounding; the splat adds a column
+                int n = steps - i;
+                if(y_inc != 0.0f) {
+                    float left = (y_inc > 0.0f ? iy + 1 - y : y - iy) * inv_y_step + 1.0f;
+                    if(left < n) n = (int)left;
+                }
+                float xe = x + n * x_inc;
+                int lo = (int)floorf(x < xe ? x : xe) - 1;
+                int hi = (int)floorf(x < xe ? xe : x) + 2;
+                top = clip_row(mask, iy, lo, hi);
+                bottom = clip_row(mask, iy + 1, lo, hi);
             }
         }
+        if(!top.count && !bottom.count) continue;
+
+        // Bilinear splat restricted to the clipped spans of its two rows
+        float fx = x - ix;
+        float fy = y - iy;
+        if(clip_contains(top, ix)) canvas->pixels[iy][ix] += (1.0f - fx) * (1.0f - fy);
+        if(clip_contains(top, ix + 1)) canvas->pixels[iy][ix + 1] += fx * (1.0f - fy);
+        if(clip_contains(bottom, ix)) canvas->pixels[iy + 1][ix] += (1.0f - fx) * fy;
+        if(clip_contains(bottom, ix + 1)) canvas->pixels[iy + 1][ix + 1] += fx * fy;
+    }
+}
+
+const viewport_mask_t* canvas_viewport_mask(canvas_t* canvas) {
+    if(!canvas->viewport) {
+        canvas->viewport = viewport_mask_circle(canvas->width, canvas->height);
     }
+    return canvas->viewport;
 }
 
 
@@ -122,6 +388,7 @@ void canvas_destroy(canvas_t* canvas){
         }
         // Free array of row pointers
         free(canvas->pixels);
+        viewport_mask_destroy(canvas->viewport);
         // Free the canvas structure itself
         free(canvas);
     }
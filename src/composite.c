@@ -0,0 +1,136 @@
+#include <string.h>
+#include "canvas.h"
+
+// Define COMPOSITE_SCALAR to build the scalar kernels only (tests compare both)
+#if !defined(COMPOSITE_SCALAR) && \
+    (defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1))
+#include <xmmintrin.h>
+#define COMPOSITE_SSE 1
+#endif
+
+// Row kernels: four floats per step with SSE, scalar tail (and fallback) //
+
+static void row_add(float* d, const float* s, int n) {
+    int x = 0;
+#ifdef COMPOSITE_SSE
+    for(; x + 4 <= n; x += 4) {
+        _mm_storeu_ps(d + x, _mm_add_ps(_mm_loadu_ps(d + x), _mm_loadu_ps(s + x)));
+    }
+#endif
+    for(; x < n; x++) d[x] += s[x];
+}
+
+static void row_max(float* d, const float* s, int n) {
+    int x = 0;
+#ifdef COMPOSITE_SSE
+    for(; x + 4 <= n; x += 4) {
+        _mm_storeu_ps(d + x, _mm_max_ps(_mm_loadu_ps(d + x), _mm_loadu_ps(s + x)));
+    }
+#endif
+    for(; x < n; x++) d[x] = d[x] > s[x] ? d[x] : s[x];
+}
+
+static void row_blend(float* d, const float* s, float alpha, int n) {
+    int x = 0;
+#ifdef COMPOSITE_SSE
+    __m128 a = _mm_set1_ps(alpha);
+    for(; x + 4 <= n; x += 4) {
+        __m128 dv = _mm_loadu_ps(d + x);
+        __m128 sv = _mm_loadu_ps(s + x);
+        _mm_storeu_ps(d + x, _mm_add_ps(dv, _mm_mul_ps(a, _mm_sub_ps(sv, dv))));
+    }
+#endif
+    for(; x < n; x++) d[x] += alpha * (s[x] - d[x]);
+}
+
+static void row_scale(float* d, float factor, int n) {
+    int x = 0;
+#ifdef COMPOSITE_SSE
+    __m128 f = _mm_set1_ps(factor);
+    for(; x + 4 <= n; x += 4) {
+        _mm_storeu_ps(d + x, _mm_mul_ps(_mm_loadu_ps(d + x), f));
+    }
+#endif
+    for(; x < n; x++) d[x] *= factor;
+}
+
+// Clips region (or the whole canvas) to both canvases; returns 0 when nothing is left
+static int clip_region(const canvas_t* a, const canvas_t* b, const canvas_rect_t* region,
+                       int* x0, int* y0, int* x1, int* y1) {
+    *x0 = 0;
+    *y0 = 0;
+    *x1 = a->width;
+    *y1 = a->height;
+    if(b) {
+        if(b->width < *x1) *x1 = b->width;
+        if(b->height < *y1) *y1 = b->height;
+    }
+    if(region) {
+        // Far edges in 64 bits so a large x + width cannot wrap around
+        long long rx1 = (long long)region->x + region->width;
+        long long ry1 = (long long)region->y + region->height;
+        if(region->x > *x0) *x0 = region->x;
+        if(region->y > *y0) *y0 = region->y;
+        if(rx1 < *x1) *x1 = (int)rx1;
+        if(ry1 < *y1) *y1 = (int)ry1;
+    }
+    return *x0 < *x1 && *y0 < *y1;
+}
+
+void canvas_add(canvas_t* dst, const canvas_t* src, const canvas_rect_t* region) {
+    int x0, y0, x1, y1;
+    if(!dst || !src || !clip_region(dst, src, region, &x0, &y0, &x1, &y1)) return;
+    for(int y = y0; y < y1; y++) {
+        row_add(dst->pixels[y] + x0, src->pixels[y] + x0, x1 - x0);
+    }
+}
+
+void canvas_max(canvas_t* dst, const canvas_t* src, const canvas_rect_t* region) {
+    int x0, y0, x1, y1;
+    if(!dst || !src || !clip_region(dst, src, region, &x0, &y0, &x1, &y1)) return;
+    for(int y = y0; y < y1; y++) {
+        row_max(dst->pixels[y] + x0, src->pixels[y] + x0, x1 - x0);
+    }
+}
+
+void canvas_blend(canvas_t* dst, const canvas_t* src, float alpha, const canvas_rect_t* region) {
+    int x0, y0, x1, y1;
+    if(!dst || !src || !clip_region(dst, src, region, &x0, &y0, &x1, &y1)) return;
+    for(int y = y0; y < y1; y++) {
+        row_blend(dst->pixels[y] + x0, src->pixels[y] + x0, alpha, x1 - x0);
+    }
+}
+
+void canvas_scale(canvas_t* canvas, float factor, const canvas_rect_t* region) {
+    int x0, y0, x1, y1;
+    if(!canvas || !clip_region(canvas, NULL, region, &x0, &y0, &x1, &y1)) return;
+    for(int y = y0; y < y1; y++) {
+        row_scale(canvas->pixels[y] + x0, factor, x1 - x0);
+    }
+}
+
+void canvas_blit(canvas_t* dst, const canvas_t* src, int dx, int dy) {
+    if(!dst || !src) return;
+
+    // Visible part of src in its own coordinates, in 64 bits so extreme offsets cannot wrap
+    long long sx0 = dx < 0 ? -(long long)dx : 0;
+    long long sy0 = dy < 0 ? -(long long)dy : 0;
+    long long sx1 = (long long)dst->width - dx;
+    long long sy1 = (long long)dst->height - dy;
+    if(src->width < sx1) sx1 = src->width;
+    if(src->height < sy1) sy1 = src->height;
+    if(sx0 >= sx1 || sy0 >= sy1) return;
+
+    // dst may be src: memmove handles overlap within a row, and moving down
+    // walks rows bottom-up so no source row is overwritten before it is read
+    size_t bytes = (size_t)(sx1 - sx0) * sizeof(float);
+    if(dst == src && dy > 0) {
+        for(int y = (int)sy1 - 1; y >= (int)sy0; y--) {
+            memmove(dst->pixels[y + dy] + sx0 + dx, src->pixels[y] + sx0, bytes);
+        }
+    } else {
+        for(int y = (int)sy0; y < (int)sy1; y++) {
+            memmove(dst->pixels[y + dy] + sx0 + dx, src->pixels[y] + sx0, bytes);
+        }
+    }
+}
@@ -0,0 +1,287 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "fixed3d.h"
+
+// Conversions //
+
+fix16_t fix16_from_float(float f) {
+    return (fix16_t)(f * FIX16_ONE + (f >= 0.0f ? 0.5f : -0.5f));
+}
+
+float fix16_to_float(fix16_t v) {
+    return (float)v / FIX16_ONE;
+}
+
+fix16_t fix16_mul(fix16_t a, fix16_t b) {
+    int64_t p = (int64_t)a * b;
+    return (fix16_t)((p + (1 << (FIX16_SHIFT - 1))) >> FIX16_SHIFT);
+}
+
+fvec3_t fvec3_from_vec3(vec3_t v) {
+    fvec3_t r = { fix16_from_float(v.x), fix16_from_float(v.y), fix16_from_float(v.z) };
+    return r;
+}
+
+fmat4_t fmat4_from_mat4(mat4_t m) {
+    fmat4_t r;
+    for (int i = 0; i < 16; ++i) r.m[i] = fix16_from_float(m.m[i]);
+    return r;
+}
+
+// Matrix functions //
+
+fmat4_t fmat4_multiply(fmat4_t A, fmat4_t B) {
+    fmat4_t result;
+    for (int row = 0; row < 4; ++row) {
+        for (int col = 0; col < 4; ++col) {
+            // Accumulate all four products before rounding once
+            int64_t sum = 0;
+            for (int k = 0; k < 4; ++k) {
+                sum += (int64_t)A.m[k * 4 + row] * B.m[col * 4 + k];
+            }
+            result.m[col * 4 + row] = (fix16_t)((sum + (1 << (FIX16_SHIFT - 1))) >> FIX16_SHIFT);
+        }
+    }
+    return result;
+}
+
+// Clip-space row: m[row] * x + m[4+row] * y + m[8+row] * z + m[12+row], rounded once
+static fix16_t transform_row(const fmat4_t *mat, int row, fvec3_t v) {
+    int64_t sum = (int64_t)mat->m[row] * v.x
+                + (int64_t)mat->m[4 + row] * v.y
+                + (int64_t)mat->m[8 + row] * v.z
+                + (int64_t)mat->m[12 + row] * FIX16_ONE;
+    return (fix16_t)((sum + (1 << (FIX16_SHIFT - 1))) >> FIX16_SHIFT);
+}
+
+fvec3_t fmat4_transform_fvec3(fmat4_t mat, fvec3_t v) {
+    fvec3_t r = { transform_row(&mat, 0, v), transform_row(&mat, 1, v), transform_row(&mat, 2, v) };
+    fix16_t w = transform_row(&mat, 3, v);
+
+    if (w != 0 && w != FIX16_ONE) {
+        r.x = (fix16_t)(((int64_t)r.x * FIX16_ONE) / w);
+        r.y = (fix16_t)(((int64_t)r.y * FIX16_ONE) / w);
+        r.z = (fix16_t)(((int64_t)r.z * FIX16_ONE) / w);
+    }
+    return r;
+}
+
+int fproject_to_screen(fmat4_t mvp, fvec3_t v, int width, int height, int *sx, int *sy) {
+    fix16_t x = transform_row(&mvp, 0, v);
+    fix16_t y = transform_row(&mvp, 1, v);
+    fix16_t w = transform_row(&mvp, 3, v);
+    if (w < FIX16_NEAR_W) return 0;
+
+    // Folds the perspective divide and viewport mapping into one integer divide per axis:
+    // sx = (x/w + 1) / 2 * width, sy = (1 - (y/w + 1) / 2) * height
+    int64_t px = ((int64_t)x + w) * width / (2 * (int64_t)w);
+    int64_t py = ((int64_t)w - y) * height / (2 * (int64_t)w);
+    if (px < -FIX16_SCREEN_LIMIT || px > FIX16_SCREEN_LIMIT ||
+        py < -FIX16_SCREEN_LIMIT || py > FIX16_SCREEN_LIMIT) return 0;
+    *sx = (int)px;
+    *sy = (int)py;
+    return 1;
+}
+
+// 8-bit canvas //
+
+canvas8_t* canvas8_create(int width, int height) {
+    if (width <= 0 || height <= 0) return NULL;
+
+    canvas8_t *canvas = malloc(sizeof(canvas8_t));
+    if (!canvas) return NULL;
+
+    canvas->width = width;
+    canvas->height = height;
+    canvas->viewport = NULL;
+    canvas->pixels = calloc((size_t)width * height, 1);
+    if (!canvas->pixels) {
+        free(canvas);
+        return NULL;
+    }
+    return canvas;
+}
+
+void canvas8_destroy(canvas8_t *canvas) {
+    if (canvas) {
+        free(canvas->pixels);
+        viewport_mask_destroy(canvas->viewport);
+        free(canvas);
+    }
+}
+
+void canvas8_clear(canvas8_t *canvas) {
+    memset(canvas->pixels, 0, (size_t)canvas->width * canvas->height);
+}
+
+// Binary PGM (P5): the buffer is already 8-bit, so no per-pixel formatting
+void canvas8_save_pgm(canvas8_t *canvas, const char *filename) {
+    if (!canvas || !filename) return;
+    FILE *file = fopen(filename, "wb");
+    if (!file) {
+        printf("Error: Could not open file %s\n", filename);
+        return;
+    }
+    fprintf(file, "P5\n%d %d\n255\n", canvas->width, canvas->height);
+    fwrite(canvas->pixels, 1, (size_t)canvas->width * canvas->height, file);
+    fclose(file);
+}
+
+const viewport_mask_t* canvas8_viewport_mask(canvas8_t *canvas) {
+    if (!canvas->viewport) {
+        canvas->viewport = viewport_mask_circle(canvas->width, canvas->height);
+    }
+    return canvas->viewport;
+}
+
+void canvas8_draw_line(canvas8_t *canvas, int x0, int y0, int x1, int y1, uint8_t intensity) {
+    canvas8_draw_line_masked(canvas, NULL, x0, y0, x1, y1, intensity);
+}
+
+// Offset along the minor axis after k steps along the major one. Every step of
+// the walk below moves the major axis, and the error term stays in a window one
+// major length wide, which pins the minor offset to this rounding of k * minor / major.
+static int64_t bresenham_minor(int64_t major, int64_t minor, int64_t k) {
+    return major ? (major + 2 * k * minor) / (2 * major) : 0;
+}
+
+// Narrows steps [*first, *last] to those whose minor offset lies in [lo, hi]
+static void bresenham_clip_minor(int64_t major, int64_t minor, int64_t lo, int64_t hi,
+                                 int64_t *first, int64_t *last) {
+    if (minor == 0) {
+        if (lo > 0 || hi < 0) *last = *first - 1;
+        return;
+    }
+    // Smallest k reaching lo, and one before the first k passing hi (ceiling divides)
+    if (lo > 0) {
+        int64_t k = ((2 * lo - 1) * major + 2 * minor - 1) / (2 * minor);
+        if (k > *first) *first = k;
+    }
+    int64_t k = hi < 0 ? -1 : ((2 * hi + 1) * major + 2 * minor - 1) / (2 * minor) - 1;
+    if (k < *last) *last = k;
+}
+
+void canvas8_draw_line_masked(canvas8_t *canvas, const viewport_mask_t *mask,
+                              int x0, int y0, int x1, int y1, uint8_t intensity) {
+    if (mask && (mask->width != canvas->width || mask->height != canvas->height)) return;
+    if (x0 < -FIX16_SCREEN_LIMIT || x0 > FIX16_SCREEN_LIMIT || y0 < -FIX16_SCREEN_LIMIT || y0 > FIX16_SCREEN_LIMIT ||
+        x1 < -FIX16_SCREEN_LIMIT || x1 > FIX16_SCREEN_LIMIT || y1 < -FIX16_SCREEN_LIMIT || y1 > FIX16_SCREEN_LIMIT) return;
+
+    int dx = x1 > x0 ? x1 - x0 : x0 - x1;
+    int dy = y1 > y0 ? y0 - y1 : y1 - y0;   // Negative absolute dy
+    int step_x = x0 < x1 ? 1 : -1;
+    int step_y = y0 < y1 ? 1 : -1;
+
+    // Clip the walk to the mask's bounding box (or the canvas) before starting it:
+    // find the first and last steps inside, then jump to the first one with the
+    // position and error term the full walk would have had there
+    int left = 0, top = 0, right = canvas->width - 1, bottom = canvas->height - 1;
+    if (mask) {
+        if (mask->xmin > mask->xmax) return;
+        left = mask->xmin;
+        top = mask->ymin;
+        right = mask->xmax;
+        bottom = mask->ymax;
+    }
+    int64_t x_lo = step_x > 0 ? (int64_t)left - x0 : (int64_t)x0 - right;
+    int64_t x_hi = step_x > 0 ? (int64_t)right - x0 : (int64_t)x0 - left;
+    int64_t y_lo = step_y > 0 ? (int64_t)top - y0 : (int64_t)y0 - bottom;
+    int64_t y_hi = step_y > 0 ? (int64_t)bottom - y0 : (int64_t)y0 - top;
+
+    int x_major = dx >= -dy;
+    int64_t major = x_major ? dx : -dy;
+    int64_t minor = x_major ? -dy : dx;
+    int64_t first = 0, last = major;
+    if (x_major) {
+        if (x_lo > first) first = x_lo;
+        if (x_hi < last) last = x_hi;
+        bresenham_clip_minor(major, minor, y_lo, y_hi, &first, &last);
+    } else {
+        if (y_lo > first) first = y_lo;
+        if (y_hi < last) last = y_hi;
+        bresenham_clip_minor(major, minor, x_lo, x_hi, &first, &last);
+    }
+    if (first > last) return;
+
+    int64_t first_minor = bresenham_minor(major, minor, first);
+    int64_t last_minor = bresenham_minor(major, minor, last);
+    int64_t x_steps = x_major ? first : first_minor;
+    int64_t y_steps = x_major ? first_minor : first;
+    int err = (int)(dx + dy + x_steps * dy + y_steps * dx);
+    x1 = x0 + step_x * (int)(x_major ? last : last_minor);
+    y1 = y0 + step_y * (int)(x_major ? last_minor : last);
+    x0 += step_x * (int)x_steps;
+    y0 += step_y * (int)y_steps;
+
+    // Drawable interval of the current row. Without a mask it is the canvas row;
+    // with one, x only moves in step_x so a cursor walks the row's spans in that
+    // direction and each pixel is compared against a single span.
+    int row = y0 - step_y;
+    int xmin = 0, xmax = -1;
+    int span = 0, span_end = 0;
+
+    while (1) {
+        if (y0 != row) {
+            row = y0;
+            xmin = 0;
+            xmax = -1;
+            span = span_end = 0;
+            if (!mask) {
+                xmax = canvas->width - 1;
+            } else {
+                span = mask->row_start[row];
+                span_end = mask->row_start[row + 1];
+                if (step_x < 0) {   // Walk right to left
+                    int leftmost = span;
+                    span = span_end - 1;
+                    span_end = leftmost - 1;
+                }
+                // Skip spans already behind x, then take the next one
+                while (span != span_end && (step_x > 0 ? mask->spans[span].xmax < x0
+                                                       : mask->spans[span].xmin > x0)) span += step_x;
+                if (span != span_end) {
+                    xmin = mask->spans[span].xmin;
+                    xmax = mask->spans[span].xmax;
+                }
+            }
+        } else if (mask && span != span_end && (step_x > 0 ? x0 > xmax : x0 < xmin)) {
+            // Moved past the current span within the row
+            span += step_x;
+            xmin = 0;
+            xmax = -1;
+            if (span != span_end) {
+                xmin = mask->spans[span].xmin;
+                xmax = mask->spans[span].xmax;
+            }
+        }
+
+        if (x0 >= xmin && x0 <= xmax) {
+            uint8_t *p = &canvas->pixels[y0 * canvas->width + x0];
+            int v = *p + intensity;
+            *p = (uint8_t)(v > 255 ? 255 : v);
+        }
+        if (x0 == x1 && y0 == y1) break;
+        int e2 = 2 * err;
+        if (e2 >= dy) { err += dy; x0 += step_x; }
+        if (e2 <= dx) { err += dx; y0 += step_y; }
+    }
+}
+
+// Clipped exactly to the circular viewport, like render_wireframe
+void render_wireframe_fixed(canvas8_t *canvas, const fvec3_t *vertices, int vertex_count,
+                            int (*edges)[2], int edge_count, fmat4_t mvp) {
+    (void)vertex_count;
+    const viewport_mask_t *mask = canvas8_viewport_mask(canvas);
+    if (!mask) {
+        printf("Error: Could not build the viewport mask\n");
+        return;
+    }
+    for (int i = 0; i < edge_count; ++i) {
+        int x0, y0, x1, y1;
+        if (!fproject_to_screen(mvp, vertices[edges[i][0]], canvas->width, canvas->height, &x0, &y0)) continue;
+        if (!fproject_to_screen(mvp, vertices[edges[i][1]], canvas->width, canvas->height, &x1, &y1)) continue;
+
+        canvas8_draw_line_masked(canvas, mask, x0, y0, x1, y1, 255);
+    }
+}
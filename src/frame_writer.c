@@ -0,0 +1,160 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "frame_writer.h"
+
+// Pool slot holding canvas, or -1 if the canvas does not belong to the writer
+static int pool_index(const frame_writer_t *writer, const canvas_t *canvas) {
+    for (int i = 0; i < writer->pool_size; ++i) {
+        if (writer->pool[i] == canvas) return i;
+    }
+    return -1;
+}
+
+static void* writer_thread(void *arg) {
+    frame_writer_t *writer = arg;
+
+    while (1) {
+        pthread_mutex_lock(&writer->lock);
+        while (writer->queue_count == 0 && !writer->stopping) {
+            pthread_cond_wait(&writer->frame_ready, &writer->lock);
+        }
+        if (writer->queue_count == 0) {     // Stopping and fully drained
+            pthread_mutex_unlock(&writer->lock);
+            break;
+        }
+        frame_job_t job = writer->queue[writer->queue_head];
+        writer->queue_head = (writer->queue_head + 1) % writer->pool_size;
+        writer->queue_count--;
+        pthread_mutex_unlock(&writer->lock);
+
+        // Quantize, write and clear outside the lock so rendering continues meanwhile
+        if (writer->format == FRAME_FORMAT_PNG) {
+            canvas_save_png(job.canvas, job.filename, writer->png_level);
+        } else {
+            canvas_save_ppm(job.canvas, job.filename);
+        }
+        canvas_clear(job.canvas);
+
+        pthread_mutex_lock(&writer->lock);
+        writer->free_canvases[writer->free_count++] = job.canvas;
+        pthread_cond_signal(&writer->canvas_free);
+        pthread_mutex_unlock(&writer->lock);
+    }
+    return NULL;
+}
+
+frame_writer_t* frame_writer_create(int width, int height, int pool_size, int writer_threads,
+                                    frame_format_t format, int png_level) {
+    if (pool_size < 1 || writer_threads < 1) return NULL;
+
+    frame_writer_t *writer = calloc(1, sizeof(frame_writer_t));
+    if (!writer) return NULL;
+
+    writer->pool = calloc(pool_size, sizeof(canvas_t*));
+    writer->free_canvases = malloc(pool_size * sizeof(canvas_t*));
+    writer->acquired = calloc(pool_size, 1);
+    writer->queue = malloc(pool_size * sizeof(frame_job_t));
+    writer->threads = malloc(writer_threads * sizeof(pthread_t));
+    if (!writer->pool || !writer->free_canvases || !writer->acquired || !writer->queue || !writer->threads) {
+        free(writer->pool);
+        free(writer->free_canvases);
+        free(writer->acquired);
+        free(writer->queue);
+        free(writer->threads);
+        free(writer);
+        return NULL;
+    }
+
+    pthread_mutex_init(&writer->lock, NULL);
+    pthread_cond_init(&writer->frame_ready, NULL);
+    pthread_cond_init(&writer->canvas_free, NULL);
+
+    writer->pool_size = pool_size;
+    writer->format = format;
+    writer->png_level = png_level;
+    for (int i = 0; i < pool_size; ++i) {
+        writer->pool[i] = canvas_create(width, height);
+        if (!writer->pool[i]) {
+            frame_writer_destroy(writer);
+            return NULL;
+        }
+        writer->free_canvases[writer->free_count++] = writer->pool[i];
+    }
+
+    for (int t = 0; t < writer_threads; ++t) {
+        if (pthread_create(&writer->threads[t], NULL, writer_thread, writer) != 0) break;
+        writer->thread_count++;
+    }
+    if (writer->thread_count == 0) {
+        frame_writer_destroy(writer);
+        return NULL;
+    }
+    return writer;
+}
+
+void frame_writer_destroy(frame_writer_t *writer) {
+    if (!writer) return;
+
+    if (writer->thread_count > 0) {
+        pthread_mutex_lock(&writer->lock);
+        writer->stopping = 1;
+        pthread_cond_broadcast(&writer->frame_ready);
+        pthread_mutex_unlock(&writer->lock);
+        for (int t = 0; t < writer->thread_count; ++t) {
+            pthread_join(writer->threads[t], NULL);
+        }
+    }
+    pthread_mutex_destroy(&writer->lock);
+    pthread_cond_destroy(&writer->frame_ready);
+    pthread_cond_destroy(&writer->canvas_free);
+
+    for (int i = 0; i < writer->pool_size; ++i) {
+        canvas_destroy(writer->pool[i]);
+    }
+    free(writer->pool);
+    free(writer->free_canvases);
+    free(writer->acquired);
+    free(writer->queue);
+    free(writer->threads);
+    free(writer);
+}
+
+canvas_t* frame_writer_acquire(frame_writer_t *writer) {
+    pthread_mutex_lock(&writer->lock);
+    while (writer->free_count == 0) {
+        pthread_cond_wait(&writer->canvas_free, &writer->lock);
+    }
+    canvas_t *canvas = writer->free_canvases[--writer->free_count];
+    writer->acquired[pool_index(writer, canvas)] = 1;
+    pthread_mutex_unlock(&writer->lock);
+    return canvas;
+}
+
+int frame_writer_submit(frame_writer_t *writer, canvas_t *canvas, const char *filename) {
+    frame_job_t job;
+    size_t length = strlen(filename);
+    if (length >= sizeof(job.filename)) {
+        printf("Error: Frame filename is longer than %d characters\n", (int)sizeof(job.filename) - 1);
+        return -1;
+    }
+    job.canvas = canvas;
+    memcpy(job.filename, filename, length + 1);
+
+    pthread_mutex_lock(&writer->lock);
+    // Only canvases handed out by acquire are accepted, once each, so the ring
+    // (pool_size slots) can never overflow and the free stack never holds duplicates
+    int slot = pool_index(writer, canvas);
+    if (slot < 0 || !writer->acquired[slot]) {
+        pthread_mutex_unlock(&writer->lock);
+        printf("Error: Canvas was not acquired from this frame writer\n");
+        return -1;
+    }
+    writer->acquired[slot] = 0;
+    int tail = (writer->queue_head + writer->queue_count) % writer->pool_size;
+    writer->queue[tail] = job;
+    writer->queue_count++;
+    pthread_cond_signal(&writer->frame_ready);
+    pthread_mutex_unlock(&writer->lock);
+    return 0;
+}
@@ -0,0 +1,92 @@
+#include "lighting.h"
+#include <math.h>
+#include <stdlib.h>
+
+// Cartesian helpers; the spherical fields are left at zero
+static vec3_t vec3_sub(vec3_t a, vec3_t b) {
+    vec3_t r = { .x = a.x - b.x, .y = a.y - b.y, .z = a.z - b.z };
+    return r;
+}
+
+static vec3_t vec3_add(vec3_t a, vec3_t b) {
+    vec3_t r = { .x = a.x + b.x, .y = a.y + b.y, .z = a.z + b.z };
+    return r;
+}
+
+static vec3_t vec3_scale(vec3_t v, float s) {
+    vec3_t r = { .x = v.x * s, .y = v.y * s, .z = v.z * s };
+    return r;
+}
+
+static float vec3_dot(vec3_t a, vec3_t b) {
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+// Lambert lighting calculation
+float calculate_lambert_lighting(vec3_t edge_dir, vec3_t light_dir) {
+    float dot_product = vec3_dot(vec3_normalize_fast(edge_dir), vec3_normalize_fast(light_dir));
+    return fmaxf(0.0f, dot_product);
+}
+
+// Calculate lighting for an edge
+float calculate_edge_lighting(vec3_t v1, vec3_t v2, light_system_t *lights) {
+    vec3_t edge_dir = vec3_normalize_fast(vec3_sub(v2, v1));
+    vec3_t edge_midpoint = vec3_scale(vec3_add(v1, v2), 0.5f);
+    
+    float total_intensity = 0.0f;
+    
+    for (int i = 0; i < lights->count; i++) {
+        vec3_t light_dir = vec3_normalize_fast(vec3_sub(lights->lights[i].position, edge_midpoint));
+        float intensity = calculate_lambert_lighting(edge_dir, light_dir);
+        total_intensity += intensity * lights->lights[i].intensity;
+    }
+    
+    return fminf(1.0f, total_intensity);
+}
+
+// Light system management
+light_system_t* create_light_system(int max_lights) {
+    light_system_t *system = malloc(sizeof(light_system_t));
+    system->lights = malloc(max_lights * sizeof(light_t));
+    system->count = 0;
+    return system;
+}
+
+void add_light(light_system_t *system, vec3_t position, vec3_t direction, float intensity, vec3_t color) {
+    light_t *light = &system->lights[system->count++];
+    light->position = position;
+    light->direction = direction;
+    light->intensity = intensity;
+    light->color = color;
+}
+
+void free_light_system(light_system_t *system) {
+    free(system->lights);
+    free(system);
+}
+
+// Lambert lighting for a whole vertex stream; normals are expected to be unit length.
+// Loops run light by light over contiguous arrays so each pass vectorizes.
+void calculate_vertex_lighting_stream(const vec3_stream_t *positions, const vec3_stream_t *normals,
+                                      light_system_t *lights, float *out_intensity) {
+    int n = positions->count < normals->count ? positions->count : normals->count;
+    for (int i = 0; i < n; i++) out_intensity[i] = 0.0f;
+
+    for (int l = 0; l < lights->count; l++) {
+        float lx = lights->lights[l].position.x;
+        float ly = lights->lights[l].position.y;
+        float lz = lights->lights[l].position.z;
+        float li = lights->lights[l].intensity;
+
+        for (int i = 0; i < n; i++) {
+            float dx = lx - positions->x[i];
+            float dy = ly - positions->y[i];
+            float dz = lz - positions->z[i];
+            float inv_len = 1.0f / sqrtf(dx * dx + dy * dy + dz * dz + 1e-8f);
+            float d = (dx * normals->x[i] + dy * normals->y[i] + dz * normals->z[i]) * inv_len;
+            out_intensity[i] += fmaxf(0.0f, d) * li;
+        }
+    }
+
+    for (int i = 0; i < n; i++) out_intensity[i] = fminf(1.0f, out_intensity[i]);
+}
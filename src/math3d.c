@@ -2,6 +2,7 @@
 #include <math.h>
 #include <stdint.h>
 #include <assert.h>
+#include <stdlib.h>
 
 // Vector functions //
 
@@ -168,3 +169,69 @@ vec3_t mat4_transform_vec3(mat4_t mat, vec3_t v) {
     return result;
 }
 
+
+// Stream functions //
+
+vec3_stream_t* vec3_stream_create(int count) {
+    if (count < 0) return NULL;
+    vec3_stream_t* stream = malloc(sizeof(vec3_stream_t));
+    if (!stream) return NULL;
+
+    // One block for all three arrays keeps the stream to a single allocation
+    stream->x = malloc((size_t)(count > 0 ? count : 1) * 3 * sizeof(float));
+    if (!stream->x) {
+        free(stream);
+        return NULL;
+    }
+    stream->y = stream->x + count;
+    stream->z = stream->y + count;
+    stream->count = count;
+    return stream;
+}
+
+void vec3_stream_destroy(vec3_stream_t* stream) {
+    if (stream) {
+        free(stream->x);
+        free(stream);
+    }
+}
+
+void vec3_stream_load_vec3(vec3_stream_t* stream, const vec3_t* vertices) {
+    for (int i = 0; i < stream->count; ++i) {
+        stream->x[i] = vertices[i].x;
+        stream->y[i] = vertices[i].y;
+        stream->z[i] = vertices[i].z;
+    }
+}
+
+void mat4_transform_stream(mat4_t mat, const vec3_stream_t* in, vec3_stream_t* out) {
+    // restrict: in and out never overlap, so the loops vectorize without alias checks
+    const float* m = mat.m;
+    const float* restrict ix = in->x;
+    const float* restrict iy = in->y;
+    const float* restrict iz = in->z;
+    float* restrict ox = out->x;
+    float* restrict oy = out->y;
+    float* restrict oz = out->z;
+    int n = in->count < out->count ? in->count : out->count;
+
+    // Affine matrices (model/view) skip the divide, leaving a branch-free loop
+    if (m[3] == 0.0f && m[7] == 0.0f && m[11] == 0.0f && m[15] == 1.0f) {
+        for (int i = 0; i < n; ++i) {
+            float x = ix[i], y = iy[i], z = iz[i];
+            ox[i] = m[0] * x + m[4] * y + m[8] * z + m[12];
+            oy[i] = m[1] * x + m[5] * y + m[9] * z + m[13];
+            oz[i] = m[2] * x + m[6] * y + m[10] * z + m[14];
+        }
+        return;
+    }
+
+    for (int i = 0; i < n; ++i) {
+        float x = ix[i], y = iy[i], z = iz[i];
+        float tw = m[3] * x + m[7] * y + m[11] * z + m[15];
+        float inv_w = tw != 0.0f ? 1.0f / tw : 1.0f;
+        ox[i] = (m[0] * x + m[4] * y + m[8] * z + m[12]) * inv_w;
+        oy[i] = (m[1] * x + m[5] * y + m[9] * z + m[13]) * inv_w;
+        oz[i] = (m[2] * x + m[6] * y + m[10] * z + m[14]) * inv_w;
+    }
+}
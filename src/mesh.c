@@ -0,0 +1,378 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "mesh.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// File mapping helpers //
+
+static void* map_file(const char *filename, int writable, size_t *size) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filename, writable ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ,
+                              FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return NULL;
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+        CloseHandle(file);
+        return NULL;
+    }
+    HANDLE mapping = CreateFileMappingA(file, NULL, writable ? PAGE_READWRITE : PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if (!mapping) return NULL;
+    void *data = MapViewOfFile(mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (!data) return NULL;
+    *size = (size_t)file_size.QuadPart;
+    return data;
+#else
+    int fd = open(filename, writable ? O_RDWR : O_RDONLY);
+    if (fd < 0) return NULL;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return NULL;
+    }
+    void *data = mmap(NULL, (size_t)st.st_size, writable ? (PROT_READ | PROT_WRITE) : PROT_READ,
+                      MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) return NULL;
+    *size = (size_t)st.st_size;
+    return data;
+#endif
+}
+
+static void unmap_file(void *data, size_t size) {
+#ifdef _WIN32
+    (void)size;
+    UnmapViewOfFile(data);
+#else
+    munmap(data, size);
+#endif
+}
+
+static int truncate_file(const char *filename, size_t size) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filename, GENERIC_WRITE, 0, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return -1;
+    LARGE_INTEGER pos;
+    pos.QuadPart = (LONGLONG)size;
+    int ok = SetFilePointerEx(file, pos, NULL, FILE_BEGIN) && SetEndOfFile(file);
+    CloseHandle(file);
+    return ok ? 0 : -1;
+#else
+    return truncate(filename, (off_t)size);
+#endif
+}
+
+// 64-bit so hostile counts cannot wrap the size check on 32-bit targets
+static uint64_t mesh_file_size(uint32_t vertex_count, uint32_t triangle_count, uint32_t edge_count) {
+    return sizeof(mesh_header_t)
+         + (uint64_t)vertex_count * 3 * sizeof(float)
+         + (uint64_t)triangle_count * 3 * sizeof(uint32_t)
+         + (uint64_t)edge_count * 2 * sizeof(uint32_t);
+}
+
+// Every index must name an existing vertex; renderers index with them unchecked
+static int indices_valid(const uint32_t *indices, size_t count, uint32_t vertex_count) {
+    for (size_t i = 0; i < count; ++i) {
+        if (indices[i] >= vertex_count) return 0;
+    }
+    return 1;
+}
+
+// Loading //
+
+mesh_t* mesh_open(const char *filename) {
+    size_t size = 0;
+    void *data = map_file(filename, 0, &size);
+    if (!data) {
+        printf("Error: Could not map mesh %s\n", filename);
+        return NULL;
+    }
+
+    const mesh_header_t *header = data;
+    if (size < sizeof(mesh_header_t) || memcmp(header->magic, MESH_MAGIC, 4) != 0 ||
+        header->version != MESH_VERSION ||
+        header->vertex_count > INT_MAX || header->triangle_count > INT_MAX || header->edge_count > INT_MAX ||
+        size < mesh_file_size(header->vertex_count, header->triangle_count, header->edge_count)) {
+        printf("Error: %s is not a valid mesh file\n", filename);
+        unmap_file(data, size);
+        return NULL;
+    }
+
+    mesh_t *mesh = malloc(sizeof(mesh_t));
+    if (!mesh) {
+        unmap_file(data, size);
+        return NULL;
+    }
+
+    const char *base = data;
+    size_t offset = sizeof(mesh_header_t);
+    mesh->positions = (const float*)(base + offset);
+    offset += (size_t)header->vertex_count * 3 * sizeof(float);
+    mesh->triangles = (const uint32_t (*)[3])(base + offset);
+    offset += (size_t)header->triangle_count * 3 * sizeof(uint32_t);
+    mesh->edges = (const uint32_t (*)[2])(base + offset);
+    mesh->vertex_count = (int)header->vertex_count;
+    mesh->triangle_count = (int)header->triangle_count;
+    mesh->edge_count = (int)header->edge_count;
+    mesh->mapping = data;
+    mesh->mapping_size = size;
+    return mesh;
+}
+
+int mesh_validate(const mesh_t *mesh) {
+    if (!indices_valid(mesh->triangles[0], (size_t)mesh->triangle_count * 3, (uint32_t)mesh->vertex_count) ||
+        !indices_valid(mesh->edges[0], (size_t)mesh->edge_count * 2, (uint32_t)mesh->vertex_count)) {
+        printf("Error: Mesh has out-of-range vertex indices\n");
+        return -1;
+    }
+    return 0;
+}
+
+void mesh_close(mesh_t *mesh) {
+    if (mesh) {
+        unmap_file(mesh->mapping, mesh->mapping_size);
+        free(mesh);
+    }
+}
+
+// OBJ conversion //
+
+// Output state for one pass over the OBJ file. The counting pass leaves the
+// FILE handles NULL; the writing pass streams each section through its own
+// handle positioned at that section's offset.
+typedef struct {
+    uint32_t vertex_count, triangle_count, edge_count;
+    uint32_t vertex_total;      // From the counting pass, for index validation
+    FILE *positions, *triangles, *edges;
+    int failed;
+} obj_pass_t;
+
+static void skip_line(FILE *in) {
+    int c;
+    do { c = getc(in); } while (c != EOF && c != '\n');
+}
+
+// Reads the next whitespace-separated token of the current line.
+// Returns 0 at end of line (consuming the newline), at a comment, or at EOF.
+static int next_token(FILE *in, char *buf, int size) {
+    int c;
+    do { c = getc(in); } while (c == ' ' || c == '\t' || c == '\r');
+    if (c == EOF || c == '\n') return 0;
+    if (c == '#') {
+        skip_line(in);
+        return 0;
+    }
+
+    int n = 0;
+    while (c != EOF && c != ' ' && c != '\t' && c != '\r' && c != '\n') {
+        if (n < size - 1) buf[n++] = (char)c;
+        c = getc(in);
+    }
+    buf[n] = '\0';
+    if (c == '\n') ungetc(c, in);
+    return 1;
+}
+
+// Resolves a 1-based (or negative, relative) OBJ index; the v/vt/vn suffix is ignored
+static int resolve_index(obj_pass_t *pass, const char *token, uint32_t *out) {
+    long index = strtol(token, NULL, 10);
+    if (index > 0) index -= 1;
+    else if (index < 0) index += pass->vertex_count;
+    else return 0;
+
+    // Only the writing pass knows the vertex total; the counting pass just needs shapes
+    if (pass->positions && (index < 0 || index >= (long)pass->vertex_total)) return 0;
+    *out = (uint32_t)index;
+    return 1;
+}
+
+static void emit_edge(obj_pass_t *pass, uint32_t a, uint32_t b) {
+    if (a == b) return;
+    if (pass->edges) {
+        uint32_t e[2] = { a < b ? a : b, a < b ? b : a };
+        if (fwrite(e, sizeof(uint32_t), 2, pass->edges) != 2) pass->failed = 1;
+    }
+    pass->edge_count++;
+}
+
+static void emit_triangle(obj_pass_t *pass, uint32_t a, uint32_t b, uint32_t c) {
+    if (pass->triangles) {
+        uint32_t t[3] = { a, b, c };
+        if (fwrite(t, sizeof(uint32_t), 3, pass->triangles) != 3) pass->failed = 1;
+    }
+    pass->triangle_count++;
+}
+
+static void obj_pass(FILE *in, obj_pass_t *pass) {
+    char token[128];
+
+    while (!pass->failed) {
+        if (!next_token(in, token, sizeof(token))) {
+            if (feof(in)) break;
+            continue;
+        }
+
+        if (strcmp(token, "v") == 0) {
+            float p[3] = { 0.0f, 0.0f, 0.0f };
+            for (int i = 0; next_token(in, token, sizeof(token)); ++i) {
+                if (i < 3) p[i] = strtof(token, NULL);   // Optional w is ignored
+            }
+            if (pass->positions && fwrite(p, sizeof(float), 3, pass->positions) != 3) pass->failed = 1;
+            pass->vertex_count++;
+        } else if (strcmp(token, "f") == 0 || strcmp(token, "l") == 0) {
+            // Polygons are fanned from their first vertex and outlined;
+            // polylines only contribute their segments
+            int is_face = (token[0] == 'f');
+            uint32_t first = 0, prev = 0, cur;
+            int n = 0;
+            while (next_token(in, token, sizeof(token))) {
+                if (!resolve_index(pass, token, &cur)) {
+                    pass->failed = 1;
+                    break;
+                }
+                if (n == 0) first = cur;
+                else emit_edge(pass, prev, cur);
+                if (is_face && n >= 2) emit_triangle(pass, first, prev, cur);
+                prev = cur;
+                n++;
+            }
+            if (pass->failed) break;
+            if (is_face && n >= 3) emit_edge(pass, prev, first);
+        } else {
+            skip_line(in);
+        }
+    }
+}
+
+static void swap_edges(uint32_t (*e)[2], size_t i, size_t j) {
+    uint32_t a = e[i][0], b = e[i][1];
+    e[i][0] = e[j][0];
+    e[i][1] = e[j][1];
+    e[j][0] = a;
+    e[j][1] = b;
+}
+
+static int edge_less(uint32_t (*e)[2], size_t i, size_t j) {
+    return e[i][0] < e[j][0] || (e[i][0] == e[j][0] && e[i][1] < e[j][1]);
+}
+
+static void sift_down(uint32_t (*e)[2], size_t root, size_t n) {
+    while (2 * root + 1 < n) {
+        size_t child = 2 * root + 1;
+        if (child + 1 < n && edge_less(e, child, child + 1)) child++;
+        if (!edge_less(e, root, child)) return;
+        swap_edges(e, root, child);
+        root = child;
+    }
+}
+
+// In-place heapsort: no scratch memory, so sorting the mapped file stays bounded
+static void sort_edges(uint32_t (*e)[2], size_t n) {
+    if (n < 2) return;
+    for (size_t i = n / 2; i-- > 0; ) sift_down(e, i, n);
+    for (size_t end = n - 1; end > 0; --end) {
+        swap_edges(e, 0, end);
+        sift_down(e, 0, end);
+    }
+}
+
+static FILE* open_section(const char *filename, size_t offset) {
+    FILE *f = fopen(filename, "r+b");
+    if (f && fseek(f, (long)offset, SEEK_SET) != 0) {
+        fclose(f);
+        return NULL;
+    }
+    return f;
+}
+
+int mesh_convert_obj(const char *obj_filename, const char *mesh_filename) {
+    FILE *in = fopen(obj_filename, "rb");
+    if (!in) {
+        printf("Error: Could not open file %s\n", obj_filename);
+        return -1;
+    }
+
+    // Pass 1: count everything so each section's offset is known up front
+    obj_pass_t counts = {0};
+    obj_pass(in, &counts);
+    if (counts.failed) {
+        printf("Error: Malformed OBJ file %s\n", obj_filename);
+        fclose(in);
+        return -1;
+    }
+
+    mesh_header_t header = {0};
+    memcpy(header.magic, MESH_MAGIC, 4);
+    header.version = MESH_VERSION;
+    header.vertex_count = counts.vertex_count;
+    header.triangle_count = counts.triangle_count;
+    header.edge_count = counts.edge_count;
+
+    FILE *out = fopen(mesh_filename, "wb");
+    if (!out) {
+        printf("Error: Could not open file %s\n", mesh_filename);
+        fclose(in);
+        return -1;
+    }
+    int ok = fwrite(&header, sizeof(header), 1, out) == 1;
+    fclose(out);
+
+    // Pass 2: stream each section through its own handle
+    size_t tri_offset = sizeof(mesh_header_t) + (size_t)counts.vertex_count * 3 * sizeof(float);
+    size_t edge_offset = tri_offset + (size_t)counts.triangle_count * 3 * sizeof(uint32_t);
+    obj_pass_t pass = {0};
+    pass.vertex_total = counts.vertex_count;
+    pass.positions = open_section(mesh_filename, sizeof(mesh_header_t));
+    pass.triangles = open_section(mesh_filename, tri_offset);
+    pass.edges = open_section(mesh_filename, edge_offset);
+    if (ok && pass.positions && pass.triangles && pass.edges) {
+        rewind(in);
+        obj_pass(in, &pass);
+        ok = !pass.failed;
+    } else {
+        ok = 0;
+    }
+    if (pass.positions && fclose(pass.positions) != 0) ok = 0;
+    if (pass.triangles && fclose(pass.triangles) != 0) ok = 0;
+    if (pass.edges && fclose(pass.edges) != 0) ok = 0;
+    fclose(in);
+    if (!ok) {
+        printf("Error: Failed to convert %s\n", obj_filename);
+        return -1;
+    }
+
+    // Shared polygon edges appear twice; sort and deduplicate them in the mapped file
+    size_t size = 0;
+    char *data = map_file(mesh_filename, 1, &size);
+    if (!data) {
+        printf("Error: Could not map mesh %s\n", mesh_filename);
+        return -1;
+    }
+    mesh_header_t *mapped = (mesh_header_t*)data;
+    uint32_t (*edges)[2] = (uint32_t (*)[2])(data + edge_offset);
+    size_t unique = 0;
+    sort_edges(edges, mapped->edge_count);
+    for (size_t i = 0; i < mapped->edge_count; ++i) {
+        if (unique == 0 || edges[i][0] != edges[unique - 1][0] || edges[i][1] != edges[unique - 1][1]) {
+            edges[unique][0] = edges[i][0];
+            edges[unique][1] = edges[i][1];
+            unique++;
+        }
+    }
+    mapped->edge_count = (uint32_t)unique;
+    unmap_file(data, size);
+
+    return truncate_file(mesh_filename, (size_t)mesh_file_size(header.vertex_count, header.triangle_count, (uint32_t)unique));
+}
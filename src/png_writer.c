@@ -0,0 +1,409 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "canvas.h"
+
+// Self-contained PNG encoder for canvas_t (8-bit grayscale).
+// Rows are filtered with the per-row heuristic from the PNG spec (pick the
+// filter with the smallest sum of absolute residuals), then compressed with a
+// greedy LZ77 + fixed-Huffman deflate. Wireframe frames are mostly black, so
+// long zero runs collapse into distance-1 matches of 258 bytes.
+
+#define WINDOW_SIZE 32768
+#define WINDOW_MASK (WINDOW_SIZE - 1)
+#define HASH_BITS 15
+#define HASH_SIZE (1 << HASH_BITS)
+#define MIN_MATCH 3
+#define MAX_MATCH 258
+
+// Growable output buffer with an LSB-first bit writer
+typedef struct {
+    uint8_t* data;
+    size_t size, capacity;
+    uint32_t bit_buf;
+    int bit_count;
+    int failed;
+} byte_buffer_t;
+
+static void buf_reserve(byte_buffer_t* b, size_t extra) {
+    if(b->failed || b->size + extra <= b->capacity) return;
+    size_t cap = b->capacity ? b->capacity : 4096;
+    while(cap < b->size + extra) cap *= 2;
+    uint8_t* grown = realloc(b->data, cap);
+    if(!grown) {
+        b->failed = 1;
+        return;
+    }
+    b->data = grown;
+    b->capacity = cap;
+}
+
+static void buf_put_byte(byte_buffer_t* b, uint8_t v) {
+    buf_reserve(b, 1);
+    if(b->failed) return;
+    b->data[b->size++] = v;
+}
+
+static void buf_put_bits(byte_buffer_t* b, uint32_t bits, int count) {
+    b->bit_buf |= bits << b->bit_count;
+    b->bit_count += count;
+    while(b->bit_count >= 8) {
+        buf_put_byte(b, (uint8_t)(b->bit_buf & 0xFF));
+        b->bit_buf >>= 8;
+        b->bit_count -= 8;
+    }
+}
+
+static void buf_flush_bits(byte_buffer_t* b) {
+    if(b->bit_count > 0) buf_put_byte(b, (uint8_t)(b->bit_buf & 0xFF));
+    b->bit_buf = 0;
+    b->bit_count = 0;
+}
+
+// Huffman codes are defined MSB-first but packed LSB-first
+static uint32_t reverse_bits(uint32_t code, int len) {
+    uint32_t r = 0;
+    for(int i = 0; i < len; i++) {
+        r = (r << 1) | (code & 1);
+        code >>= 1;
+    }
+    return r;
+}
+
+static void put_fixed_symbol(byte_buffer_t* b, int sym) {
+    if(sym < 144)      buf_put_bits(b, reverse_bits(0x30 + sym, 8), 8);
+    else if(sym < 256) buf_put_bits(b, reverse_bits(0x190 + (sym - 144), 9), 9);
+    else if(sym < 280) buf_put_bits(b, reverse_bits(sym - 256, 7), 7);
+    else               buf_put_bits(b, reverse_bits(0xC0 + (sym - 280), 8), 8);
+}
+
+static const int length_base[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+static const int length_extra[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+static const int dist_base[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+static const int dist_extra[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+
+static void put_match(byte_buffer_t* b, int length, int distance) {
+    int lc = 28;
+    while(length_base[lc] > length) lc--;
+    put_fixed_symbol(b, 257 + lc);
+    if(length_extra[lc]) buf_put_bits(b, length - length_base[lc], length_extra[lc]);
+
+    int dc = 29;
+    while(dist_base[dc] > distance) dc--;
+    buf_put_bits(b, reverse_bits(dc, 5), 5);
+    if(dist_extra[dc]) buf_put_bits(b, distance - dist_base[dc], dist_extra[dc]);
+}
+
+static void deflate_stored(byte_buffer_t* b, const uint8_t* in, size_t len) {
+    size_t pos = 0;
+    do {
+        size_t chunk = len - pos > 65535 ? 65535 : len - pos;
+        int final = (pos + chunk == len);
+        buf_put_bits(b, final, 1);
+        buf_put_bits(b, 0, 2);
+        buf_flush_bits(b);
+        buf_put_byte(b, chunk & 0xFF);
+        buf_put_byte(b, (chunk >> 8) & 0xFF);
+        buf_put_byte(b, ~chunk & 0xFF);
+        buf_put_byte(b, (~chunk >> 8) & 0xFF);
+        buf_reserve(b, chunk);
+        if(b->failed) return;
+        memcpy(b->data + b->size, in + pos, chunk);
+        b->size += chunk;
+        pos += chunk;
+    } while(pos < len);
+}
+
+static uint32_t hash3(const uint8_t* p) {
+    uint32_t v = ((uint32_t)p[0] << 16) | ((uint32_t)p[1] << 8) | p[2];
+    return (v * 2654435761u) >> (32 - HASH_BITS);
+}
+
+// Greedy LZ77 over the whole buffer, emitted as a single fixed-Huffman block
+static void deflate_fixed(byte_buffer_t* b, const uint8_t* in, size_t len, int level) {
+    static const int chain_limits[10] = { 0, 4, 8, 16, 32, 64, 128, 256, 1024, 4096 };
+    int max_chain = chain_limits[level];
+
+    int* head = malloc(HASH_SIZE * sizeof(int));
+    int* prev = malloc(WINDOW_SIZE * sizeof(int));
+    if(!head || !prev) {
+        free(head);
+        free(prev);
+        b->failed = 1;
+        return;
+    }
+    for(int i = 0; i < HASH_SIZE; i++) head[i] = -1;
+
+    buf_put_bits(b, 1, 1);  // BFINAL
+    buf_put_bits(b, 1, 2);  // BTYPE = fixed Huffman
+
+    size_t pos = 0;
+    while(pos < len) {
+        int best_len = 0, best_dist = 0;
+
+        if(pos + MIN_MATCH <= len) {
+            uint32_t h = hash3(in + pos);
+            int cand = head[h];
+            int chain = max_chain;
+            size_t max_len = len - pos < MAX_MATCH ? len - pos : MAX_MATCH;
+
+            while(cand >= 0 && pos - (size_t)cand <= WINDOW_SIZE && chain-- > 0) {
+                const uint8_t* a = in + cand;
+                const uint8_t* c = in + pos;
+                if(a[best_len] == c[best_len]) {
+                    size_t n = 0;
+                    while(n < max_len && a[n] == c[n]) n++;
+                    if((int)n > best_len) {
+                        best_len = (int)n;
+                        best_dist = (int)(pos - cand);
+                        if(n == max_len) break;
+                    }
+                }
+                int next = prev[cand & WINDOW_MASK];
+                if(next >= cand) break;
+                cand = next;
+            }
+        }
+
+        size_t advance = 1;
+        if(best_len >= MIN_MATCH) {
+            put_match(b, best_len, best_dist);
+            advance = best_len;
+        } else {
+            put_fixed_symbol(b, in[pos]);
+        }
+
+        // Insert every covered position so later matches can reference them
+        for(size_t i = 0; i < advance; i++, pos++) {
+            if(pos + MIN_MATCH <= len) {
+                uint32_t h = hash3(in + pos);
+                prev[pos & WINDOW_MASK] = head[h];
+                head[h] = (int)pos;
+            }
+        }
+    }
+    put_fixed_symbol(b, 256);  // End of block
+    buf_flush_bits(b);
+
+    free(head);
+    free(prev);
+}
+
+// CRC-32 (polynomial 0xEDB88320) per byte value; a constant so concurrent
+// writer threads never race on initialisation
+static const uint32_t crc_table[256] = {
+    0x00000000u, 0x77073096u, 0xEE0E612Cu, 0x990951BAu, 0x076DC419u, 0x706AF48Fu,
+    0xE963A535u, 0x9E6495A3u, 0x0EDB8832u, 0x79DCB8A4u, 0xE0D5E91Eu, 0x97D2D988u,
+    0x09B64C2Bu, 0x7EB17CBDu, 0xE7B82D07u, 0x90BF1D91u, 0x1DB71064u, 0x6AB020F2u,
+    0xF3B97148u, 0x84BE41DEu, 0x1ADAD47Du, 0x6DDDE4EBu, 0xF4D4B551u, 0x83D385C7u,
+    0x136C9856u, 0x646BA8C0u, 0xFD62F97Au, 0x8A65C9ECu, 0x14015C4Fu, 0x63066CD9u,
+    0xFA0F3D63u, 0x8D080DF5u, 0x3B6E20C8u, 0x4C69105Eu, 0xD56041E4u, 0xA2677172u,
+    0x3C03E4D1u, 0x4B04D447u, 0xD20D85FDu, 0xA50AB56Bu, 0x35B5A8FAu, 0x42B2986Cu,
+    0xDBBBC9D6u, 0xACBCF940u, 0x32D86CE3u, 0x45DF5C75u, 0xDCD60DCFu, 0xABD13D59u,
+    0x26D930ACu, 0x51DE003Au, 0xC8D75180u, 0xBFD06116u, 0x21B4F4B5u, 0x56B3C423u,
+    0xCFBA9599u, 0xB8BDA50Fu, 0x2802B89Eu, 0x5F058808u, 0xC60CD9B2u, 0xB10BE924u,
+    0x2F6F7C87u, 0x58684C11u, 0xC1611DABu, 0xB6662D3Du, 0x76DC4190u, 0x01DB7106u,
+    0x98D220BCu, 0xEFD5102Au, 0x71B18589u, 0x06B6B51Fu, 0x9FBFE4A5u, 0xE8B8D433u,
+    0x7807C9A2u, 0x0F00F934u, 0x9609A88Eu, 0xE10E9818u, 0x7F6A0DBBu, 0x086D3D2Du,
+    0x91646C97u, 0xE6635C01u, 0x6B6B51F4u, 0x1C6C6162u, 0x856530D8u, 0xF262004Eu,
+    0x6C0695EDu, 0x1B01A57Bu, 0x8208F4C1u, 0xF50FC457u, 0x65B0D9C6u, 0x12B7E950u,
+    0x8BBEB8EAu, 0xFCB9887Cu, 0x62DD1DDFu, 0x15DA2D49u, 0x8CD37CF3u, 0xFBD44C65u,
+    0x4DB26158u, 0x3AB551CEu, 0xA3BC0074u, 0xD4BB30E2u, 0x4ADFA541u, 0x3DD895D7u,
+    0xA4D1C46Du, 0xD3D6F4FBu, 0x4369E96Au, 0x346ED9FCu, 0xAD678846u, 0xDA60B8D0u,
+    0x44042D73u, 0x33031DE5u, 0xAA0A4C5Fu, 0xDD0D7CC9u, 0x5005713Cu, 0x270241AAu,
+    0xBE0B1010u, 0xC90C2086u, 0x5768B525u, 0x206F85B3u, 0xB966D409u, 0xCE61E49Fu,
+    0x5EDEF90Eu, 0x29D9C998u, 0xB0D09822u, 0xC7D7A8B4u, 0x59B33D17u, 0x2EB40D81u,
+    0xB7BD5C3Bu, 0xC0BA6CADu, 0xEDB88320u, 0x9ABFB3B6u, 0x03B6E20Cu, 0x74B1D29Au,
+    0xEAD54739u, 0x9DD277AFu, 0x04DB2615u, 0x73DC1683u, 0xE3630B12u, 0x94643B84u,
+    0x0D6D6A3Eu, 0x7A6A5AA8u, 0xE40ECF0Bu, 0x9309FF9Du, 0x0A00AE27u, 0x7D079EB1u,
+    0xF00F9344u, 0x8708A3D2u, 0x1E01F268u, 0x6906C2FEu, 0xF762575Du, 0x806567CBu,
+    0x196C3671u, 0x6E6B06E7u, 0xFED41B76u, 0x89D32BE0u, 0x10DA7A5Au, 0x67DD4ACCu,
+    0xF9B9DF6Fu, 0x8EBEEFF9u, 0x17B7BE43u, 0x60B08ED5u, 0xD6D6A3E8u, 0xA1D1937Eu,
+    0x38D8C2C4u, 0x4FDFF252u, 0xD1BB67F1u, 0xA6BC5767u, 0x3FB506DDu, 0x48B2364Bu,
+    0xD80D2BDAu, 0xAF0A1B4Cu, 0x36034AF6u, 0x41047A60u, 0xDF60EFC3u, 0xA867DF55u,
+    0x316E8EEFu, 0x4669BE79u, 0xCB61B38Cu, 0xBC66831Au, 0x256FD2A0u, 0x5268E236u,
+    0xCC0C7795u, 0xBB0B4703u, 0x220216B9u, 0x5505262Fu, 0xC5BA3BBEu, 0xB2BD0B28u,
+    0x2BB45A92u, 0x5CB36A04u, 0xC2D7FFA7u, 0xB5D0CF31u, 0x2CD99E8Bu, 0x5BDEAE1Du,
+    0x9B64C2B0u, 0xEC63F226u, 0x756AA39Cu, 0x026D930Au, 0x9C0906A9u, 0xEB0E363Fu,
+    0x72076785u, 0x05005713u, 0x95BF4A82u, 0xE2B87A14u, 0x7BB12BAEu, 0x0CB61B38u,
+    0x92D28E9Bu, 0xE5D5BE0Du, 0x7CDCEFB7u, 0x0BDBDF21u, 0x86D3D2D4u, 0xF1D4E242u,
+    0x68DDB3F8u, 0x1FDA836Eu, 0x81BE16CDu, 0xF6B9265Bu, 0x6FB077E1u, 0x18B74777u,
+    0x88085AE6u, 0xFF0F6A70u, 0x66063BCAu, 0x11010B5Cu, 0x8F659EFFu, 0xF862AE69u,
+    0x616BFFD3u, 0x166CCF45u, 0xA00AE278u, 0xD70DD2EEu, 0x4E048354u, 0x3903B3C2u,
+    0xA7672661u, 0xD06016F7u, 0x4969474Du, 0x3E6E77DBu, 0xAED16A4Au, 0xD9D65ADCu,
+    0x40DF0B66u, 0x37D83BF0u, 0xA9BCAE53u, 0xDEBB9EC5u, 0x47B2CF7Fu, 0x30B5FFE9u,
+    0xBDBDF21Cu, 0xCABAC28Au, 0x53B39330u, 0x24B4A3A6u, 0xBAD03605u, 0xCDD70693u,
+    0x54DE5729u, 0x23D967BFu, 0xB3667A2Eu, 0xC4614AB8u, 0x5D681B02u, 0x2A6F2B94u,
+    0xB40BBE37u, 0xC30C8EA1u, 0x5A05DF1Bu, 0x2D02EF8Du
+};
+
+static uint32_t crc32_update(uint32_t crc, const uint8_t* data, size_t len) {
+    for(size_t i = 0; i < len; i++) crc = crc_table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return crc;
+}
+
+static uint32_t adler32(const uint8_t* data, size_t len) {
+    uint32_t a = 1, b = 0;
+    while(len > 0) {
+        size_t block = len < 5552 ? len : 5552;  // Largest block without overflow
+        len -= block;
+        while(block--) {
+            a += *data++;
+            b += a;
+        }
+        a %= 65521;
+        b %= 65521;
+    }
+    return (b << 16) | a;
+}
+
+static void put_u32_be(uint8_t* p, uint32_t v) {
+    p[0] = (v >> 24) & 0xFF;
+    p[1] = (v >> 16) & 0xFF;
+    p[2] = (v >> 8) & 0xFF;
+    p[3] = v & 0xFF;
+}
+
+static void write_chunk(FILE* file, const char* type, const uint8_t* data, size_t len) {
+    uint8_t header[8];
+    put_u32_be(header, (uint32_t)len);
+    memcpy(header + 4, type, 4);
+    fwrite(header, 1, 8, file);
+    if(len) fwrite(data, 1, len, file);
+
+    uint32_t crc = crc32_update(0xFFFFFFFFu, (const uint8_t*)type, 4);
+    crc = crc32_update(crc, data, len) ^ 0xFFFFFFFFu;
+    uint8_t tail[4];
+    put_u32_be(tail, crc);
+    fwrite(tail, 1, 4, file);
+}
+
+static int paeth(int a, int b, int c) {
+    int p = a + b - c;
+    int pa = abs(p - a), pb = abs(p - b), pc = abs(p - c);
+    if(pa <= pb && pa <= pc) return a;
+    if(pb <= pc) return b;
+    return c;
+}
+
+// Filters one row into out[0..width] (out[0] is the filter type byte)
+static void filter_row(const uint8_t* row, const uint8_t* above, int width, uint8_t* out, uint8_t* scratch) {
+    long best_score = -1;
+    for(int type = 0; type < 5; type++) {
+        long score = 0;
+        for(int x = 0; x < width; x++) {
+            int a = x > 0 ? row[x - 1] : 0;
+            int b = above ? above[x] : 0;
+            int c = (x > 0 && above) ? above[x - 1] : 0;
+            int pred;
+            switch(type) {
+                case 1:  pred = a; break;
+                case 2:  pred = b; break;
+                case 3:  pred = (a + b) / 2; break;
+                case 4:  pred = paeth(a, b, c); break;
+                default: pred = 0; break;
+            }
+            uint8_t v = (uint8_t)(row[x] - pred);
+            scratch[x] = v;
+            score += v < 128 ? v : 256 - v;
+        }
+        if(best_score < 0 || score < best_score) {
+            best_score = score;
+            out[0] = (uint8_t)type;
+            memcpy(out + 1, scratch, width);
+        }
+    }
+}
+
+void canvas_save_png(canvas_t* canvas, const char* filename, int level) {
+    if(!canvas || !filename) return;
+    if(level < 0) level = 0;
+    if(level > 9) level = 9;
+
+    int w = canvas->width, h = canvas->height;
+    size_t stride = (size_t)w + 1;
+    uint8_t* gray = malloc((size_t)w * 2);
+    uint8_t* scratch = malloc(w);
+    uint8_t* filtered = malloc(stride * h);
+    if(!gray || !scratch || !filtered) {
+        printf("Error: Out of memory while encoding %s\n", filename);
+        free(gray);
+        free(scratch);
+        free(filtered);
+        return;
+    }
+
+    // Quantize exactly like canvas_save_ppm, keeping the previous row for filtering
+    for(int y = 0; y < h; y++) {
+        uint8_t* row = gray + (size_t)(y & 1) * w;
+        uint8_t* above = y > 0 ? gray + (size_t)((y - 1) & 1) * w : NULL;
+        for(int x = 0; x < w; x++) {
+            int pixel_value = (int)(canvas->pixels[y][x] * 255);
+            if(pixel_value > 255) pixel_value = 255;
+            if(pixel_value < 0) pixel_value = 0;
+            row[x] = (uint8_t)pixel_value;
+        }
+        if(level == 0) {
+            filtered[y * stride] = 0;
+            memcpy(filtered + y * stride + 1, row, w);
+        } else {
+            filter_row(row, above, w, filtered + y * stride, scratch);
+        }
+    }
+    free(gray);
+    free(scratch);
+
+    byte_buffer_t zbuf = {0};
+    static const uint8_t zlib_flags[10] = { 0x01, 0x01, 0x5E, 0x5E, 0x5E, 0x5E, 0x9C, 0xDA, 0xDA, 0xDA };
+    buf_put_byte(&zbuf, 0x78);
+    buf_put_byte(&zbuf, zlib_flags[level]);
+    if(level == 0) deflate_stored(&zbuf, filtered, stride * h);
+    else deflate_fixed(&zbuf, filtered, stride * h, level);
+    uint32_t checksum = adler32(filtered, stride * h);
+    for(int i = 3; i >= 0; i--) buf_put_byte(&zbuf, (checksum >> (i * 8)) & 0xFF);
+    free(filtered);
+
+    if(zbuf.failed) {
+        printf("Error: Out of memory while encoding %s\n", filename);
+        free(zbuf.data);
+        return;
+    }
+
+    FILE* file = fopen(filename, "wb");
+    if(!file) {
+        printf("Error: Could not open file %s\n", filename);
+        free(zbuf.data);
+        return;
+    }
+
+    static const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    fwrite(signature, 1, 8, file);
+
+    uint8_t ihdr[13];
+    put_u32_be(ihdr, (uint32_t)w);
+    put_u32_be(ihdr + 4, (uint32_t)h);
+    ihdr[8] = 8;   // Bit depth
+    ihdr[9] = 0;   // Color type: grayscale
+    ihdr[10] = 0;  // Compression: deflate
+    ihdr[11] = 0;  // Filter method: adaptive
+    ihdr[12] = 0;  // No interlace
+    write_chunk(file, "IHDR", ihdr, sizeof(ihdr));
+    write_chunk(file, "IDAT", zbuf.data, zbuf.size);
+    write_chunk(file, "IEND", NULL, 0);
+
+    fclose(file);
+    free(zbuf.data);
+}
@@ -1,8 +1,10 @@
 #include <stdio.h>
 #include "renderer.h"
 #include "canvas.h"
+#include "mesh.h"
 #include <math.h>
 #include<stdlib.h>
+#include <pthread.h>
 
 // Projects a 3D vertex through model → view → projection transforms
 vec3_t project_vertex(vec3_t vertex, mat4_t model, mat4_t view, mat4_t projection) {
@@ -22,21 +24,432 @@ int clip_to_circular_viewport(canvas_t* canvas, int x, int y) {
     return (dx * dx + dy * dy <= radius * radius);
 }
 
-// Draws a wireframe using projected 3D vertices
+// Maps a projected (NDC) vertex to canvas pixel coordinates
+static vec3_t ndc_to_screen(canvas_t* canvas, vec3_t p) {
+    vec3_t s = p;
+    s.x = (p.x + 1.0f) * 0.5f * canvas->width;
+    s.y = (1.0f - (p.y + 1.0f) * 0.5f) * canvas->height;
+    return s;
+}
+
+// Batch projection: NDC through mvp, then x/y mapped to pixels (z stays NDC depth)
+void project_stream(canvas_t* canvas, mat4_t mvp, const vec3_stream_t* in, vec3_stream_t* screen) {
+    mat4_transform_stream(mvp, in, screen);
+
+    float sx = 0.5f * canvas->width;
+    float sy = 0.5f * canvas->height;
+    float* x = screen->x;
+    float* y = screen->y;
+    for (int i = 0; i < screen->count; ++i) {
+        x[i] = (x[i] + 1.0f) * sx;
+        y[i] = (1.0f - y[i]) * sy;
+    }
+}
+
+// The canvas's cached circular viewport; NULL (after reporting it) if it could not be built
+static const viewport_mask_t* circle_mask(canvas_t* canvas) {
+    const viewport_mask_t* mask = canvas_viewport_mask(canvas);
+    if (!mask) printf("Error: Could not build the viewport mask\n");
+    return mask;
+}
+
+// A mask of another size would index rows and columns the canvas does not have
+static int mask_fits(canvas_t* canvas, const viewport_mask_t* mask) {
+    if (mask && (mask->width != canvas->width || mask->height != canvas->height)) {
+        printf("Error: Viewport mask is %dx%d but the canvas is %dx%d\n",
+               mask->width, mask->height, canvas->width, canvas->height);
+        return 0;
+    }
+    return 1;
+}
+
+// Draws a wireframe using projected 3D vertices, clipped to the circular viewport
 void render_wireframe(canvas_t* canvas, vec3_t* vertices, int vertex_count, int (*edges)[2], int edge_count,
                       mat4_t model, mat4_t view, mat4_t projection) {
+    const viewport_mask_t* mask = circle_mask(canvas);
+    if (!mask) return;
+    render_wireframe_masked(canvas, mask, vertices, vertex_count, edges, edge_count, model, view, projection);
+}
+
+void render_wireframe_masked(canvas_t* canvas, const viewport_mask_t* mask, vec3_t* vertices, int vertex_count,
+                             int (*edges)[2], int edge_count, mat4_t model, mat4_t view, mat4_t projection) {
     (void)vertex_count;
+    if (!mask_fits(canvas, mask)) return;
+    for (int i = 0; i < edge_count; ++i) {
+        vec3_t p0 = ndc_to_screen(canvas, project_vertex(vertices[edges[i][0]], model, view, projection));
+        vec3_t p1 = ndc_to_screen(canvas, project_vertex(vertices[edges[i][1]], model, view, projection));
+
+        int x0 = (int)p0.x;
+        int y0 = (int)p0.y;
+        int x1 = (int)p1.x;
+        int y1 = (int)p1.y;
+
+        draw_line_f_masked(canvas, mask, x0, y0, x1, y1, 1.0f); // Draw white line
+    }
+}
+
+// Stream variant: every vertex is projected once into a scratch stream, then edges index it
+void render_wireframe_stream(canvas_t* canvas, const viewport_mask_t* mask, const vec3_stream_t* vertices,
+                             int (*edges)[2], int edge_count, mat4_t model, mat4_t view, mat4_t projection) {
+    if (!mask_fits(canvas, mask)) return;
+    vec3_stream_t* screen = vec3_stream_create(vertices->count);
+    if (!screen) return;
+    project_stream(canvas, mat4_multiply(projection, mat4_multiply(view, model)), vertices, screen);
+
     for (int i = 0; i < edge_count; ++i) {
-        vec3_t p0 = project_vertex(vertices[edges[i][0]], model, view, projection);
-        vec3_t p1 = project_vertex(vertices[edges[i][1]], model, view, projection);
+        int a = edges[i][0], b = edges[i][1];
+        draw_line_f_masked(canvas, mask, (int)screen->x[a], (int)screen->y[a],
+                           (int)screen->x[b], (int)screen->y[b], 1.0f);
+    }
+    vec3_stream_destroy(screen);
+}
+
+// Shared state for render_wireframe_multi workers
+typedef struct {
+    const vec3_t* world;
+    int vertex_count;
+    int (*edges)[2];
+    int edge_count;
+    const render_view_t* views;
+    int view_count;
+    int next_view;
+    pthread_mutex_t lock;
+} multi_view_job_t;
+
+// Projects the world-space vertices once for this view, then draws its edges.
+// View and projection are applied in turn, as project_vertex does, so every
+// view matches render_wireframe pixel for pixel.
+static void render_view(const multi_view_job_t* job, const render_view_t* view, float (*screen)[2]) {
+    canvas_t* canvas = view->canvas;
+    const viewport_mask_t* mask = circle_mask(canvas);
+    if (!mask) return;
+
+    for (int i = 0; i < job->vertex_count; ++i) {
+        vec3_t camera = mat4_transform_vec3(view->view, job->world[i]);
+        vec3_t s = ndc_to_screen(canvas, mat4_transform_vec3(view->projection, camera));
+        screen[i][0] = s.x;
+        screen[i][1] = s.y;
+    }
+
+    for (int i = 0; i < job->edge_count; ++i) {
+        int x0 = (int)screen[job->edges[i][0]][0];
+        int y0 = (int)screen[job->edges[i][0]][1];
+        int x1 = (int)screen[job->edges[i][1]][0];
+        int y1 = (int)screen[job->edges[i][1]][1];
+        draw_line_f_masked(canvas, mask, x0, y0, x1, y1, 1.0f);
+    }
+}
+
+// One worker thread's arguments: the shared job and its own projection scratch
+typedef struct {
+    multi_view_job_t* job;
+    float (*screen)[2];
+} multi_view_worker_t;
+
+static void* multi_view_worker(void* arg) {
+    multi_view_worker_t* worker = arg;
+    multi_view_job_t* job = worker->job;
+
+    while (1) {
+        pthread_mutex_lock(&job->lock);
+        int v = job->next_view++;
+        pthread_mutex_unlock(&job->lock);
+        if (v >= job->view_count) break;
+        render_view(job, &job->views[v], worker->screen);
+    }
+    return NULL;
+}
+
+// Renders one model into several views: the model transform runs once, then
+// views are handed out to worker threads (each view owns its canvas).
+// All scratch memory is allocated before any thread starts, so a failure
+// leaves every canvas untouched.
+int render_wireframe_multi(vec3_t* vertices, int vertex_count, int (*edges)[2], int edge_count,
+                           mat4_t model, const render_view_t* views, int view_count, int thread_count) {
+    if (view_count <= 0) return 0;
+    if (thread_count < 1) thread_count = 1;
+    if (thread_count > view_count) thread_count = view_count;
+
+    vec3_t* world = malloc((size_t)vertex_count * sizeof(vec3_t));
+    multi_view_worker_t* workers = calloc((size_t)thread_count, sizeof(multi_view_worker_t));
+    pthread_t* threads = malloc((size_t)thread_count * sizeof(pthread_t));
+    int ok = world && workers && threads;
+    for (int t = 0; ok && t < thread_count; ++t) {
+        workers[t].screen = malloc((size_t)vertex_count * sizeof(float[2]));
+        if (!workers[t].screen) ok = 0;
+    }
+    if (!ok) {
+        printf("Error: Could not allocate multi-view scratch for %d threads\n", thread_count);
+        for (int t = 0; workers && t < thread_count; ++t) free(workers[t].screen);
+        free(threads);
+        free(workers);
+        free(world);
+        return -1;
+    }
+
+    for (int i = 0; i < vertex_count; ++i) {
+        world[i] = mat4_transform_vec3(model, vertices[i]);
+    }
+
+    multi_view_job_t job;
+    job.world = world;
+    job.vertex_count = vertex_count;
+    job.edges = edges;
+    job.edge_count = edge_count;
+    job.views = views;
+    job.view_count = view_count;
+    job.next_view = 0;
+    pthread_mutex_init(&job.lock, NULL);
+
+    // Worker 0 is the calling thread; if a thread fails to start, the others take its views
+    int started = 0;
+    for (int t = 1; t < thread_count; ++t) {
+        workers[t].job = &job;
+        if (pthread_create(&threads[t], NULL, multi_view_worker, &workers[t]) != 0) break;
+        started++;
+    }
+    workers[0].job = &job;
+    multi_view_worker(&workers[0]);
+    for (int t = 1; t <= started; ++t) {
+        pthread_join(threads[t], NULL);
+    }
+
+    pthread_mutex_destroy(&job.lock);
+    for (int t = 0; t < thread_count; ++t) free(workers[t].screen);
+    free(threads);
+    free(workers);
+    free(world);
+    return 0;
+}
+
+// Draws a memory-mapped mesh, reading positions and edges straight from the file mapping
+void render_wireframe_mesh(canvas_t* canvas, const mesh_t* mesh, mat4_t model, mat4_t view, mat4_t projection) {
+    // Project each vertex once; large meshes share every vertex between several edges
+    const viewport_mask_t* mask = circle_mask(canvas);
+    if (!mask) return;
+    float (*screen)[2] = malloc((size_t)mesh->vertex_count * sizeof(float[2]));
+    if (!screen) return;
 
-        int x0 = (int)((p0.x + 1.0f) * 0.5f * canvas->width);
-        int y0 = (int)((1.0f - (p0.y + 1.0f) * 0.5f) * canvas->height);
-        int x1 = (int)((p1.x + 1.0f) * 0.5f * canvas->width);
-        int y1 = (int)((1.0f - (p1.y + 1.0f) * 0.5f) * canvas->height);
+    for (int i = 0; i < mesh->vertex_count; ++i) {
+        const float* p = &mesh->positions[i * 3];
+        vec3_t v = { .x = p[0], .y = p[1], .z = p[2] };
+        vec3_t s = ndc_to_screen(canvas, project_vertex(v, model, view, projection));
+        screen[i][0] = s.x;
+        screen[i][1] = s.y;
+    }
+
+    for (int i = 0; i < mesh->edge_count; ++i) {
+        int x0 = (int)screen[mesh->edges[i][0]][0];
+        int y0 = (int)screen[mesh->edges[i][0]][1];
+        int x1 = (int)screen[mesh->edges[i][1]][0];
+        int y1 = (int)screen[mesh->edges[i][1]][1];
+
+        draw_line_f_masked(canvas, mask, x0, y0, x1, y1, 1.0f);
+    }
+
+    free(screen);
+}
+
+float* depth_buffer_create(canvas_t* canvas) {
+    float* depth = malloc((size_t)canvas->width * canvas->height * sizeof(float));
+    if (depth) depth_buffer_clear(canvas, depth);
+    return depth;
+}
+
+void depth_buffer_clear(canvas_t* canvas, float* depth) {
+    int count = canvas->width * canvas->height;
+    for (int i = 0; i < count; ++i) depth[i] = INFINITY;
+}
+
+#define RASTER_BLOCK 8
+
+// Edge function E(x, y) = a*x + b*y + c, positive on the inside of the triangle
+typedef struct {
+    float a, b, c;
+} edge_fn_t;
 
-        if (clip_to_circular_viewport(canvas, x0, y0) || clip_to_circular_viewport(canvas, x1, y1)) {
-            draw_line_f(canvas, x0, y0, x1, y1, 1.0f); // Draw white line
+static edge_fn_t make_edge(vec3_t j, vec3_t k) {
+    edge_fn_t e;
+    e.a = -(k.y - j.y);
+    e.b = k.x - j.x;
+    e.c = (k.y - j.y) * j.x - (k.x - j.x) * j.y;
+    return e;
+}
+
+// Half-space rasterizer: walks the bounding box in 8x8 blocks, rejects blocks
+// outside any edge, fills fully covered blocks without per-pixel edge tests
+// and only tests pixels in blocks that straddle an edge.
+static void raster_triangle(canvas_t* canvas, float* depth, vec3_t v0, vec3_t v1, vec3_t v2,
+                            float i0, float i1, float i2) {
+    edge_fn_t e[3] = { make_edge(v1, v2), make_edge(v2, v0), make_edge(v0, v1) };
+    float area = e[0].a * v0.x + e[0].b * v0.y + e[0].c;
+    if (fabsf(area) < 1e-6f) return;
+    if (area < 0.0f) {
+        for (int k = 0; k < 3; ++k) {
+            e[k].a = -e[k].a; e[k].b = -e[k].b; e[k].c = -e[k].c;
+        }
+        area = -area;
+    }
+    float inv_area = 1.0f / area;
+
+    int minx = (int)ceilf(fminf(v0.x, fminf(v1.x, v2.x)));
+    int maxx = (int)floorf(fmaxf(v0.x, fmaxf(v1.x, v2.x)));
+    int miny = (int)ceilf(fminf(v0.y, fminf(v1.y, v2.y)));
+    int maxy = (int)floorf(fmaxf(v0.y, fmaxf(v1.y, v2.y)));
+    if (minx < 0) minx = 0;
+    if (miny < 0) miny = 0;
+    if (maxx > canvas->width - 1) maxx = canvas->width - 1;
+    if (maxy > canvas->height - 1) maxy = canvas->height - 1;
+    if (minx > maxx || miny > maxy) return;
+
+    // Attribute planes in terms of the edge weights: attr = sum(w_k * attr_k) / area
+    float z0 = v0.z * inv_area, z1 = v1.z * inv_area, z2 = v2.z * inv_area;
+    float s0 = i0 * inv_area, s1 = i1 * inv_area, s2 = i2 * inv_area;
+
+    for (int by = miny; by <= maxy; by += RASTER_BLOCK) {
+        int bh = (maxy - by + 1) < RASTER_BLOCK ? (maxy - by + 1) : RASTER_BLOCK;
+        for (int bx = minx; bx <= maxx; bx += RASTER_BLOCK) {
+            int bw = (maxx - bx + 1) < RASTER_BLOCK ? (maxx - bx + 1) : RASTER_BLOCK;
+
+            int reject = 0, full = 1;
+            for (int k = 0; k < 3; ++k) {
+                float base = e[k].a * bx + e[k].b * by + e[k].c;
+                float dx = e[k].a * (bw - 1), dy = e[k].b * (bh - 1);
+                float hi = base + fmaxf(dx, 0.0f) + fmaxf(dy, 0.0f);
+                float lo = base + fminf(dx, 0.0f) + fminf(dy, 0.0f);
+                if (hi < 0.0f) reject = 1;
+                if (lo < 0.0f) full = 0;
+            }
+            if (reject) continue;
+
+            for (int y = by; y < by + bh; ++y) {
+                float w0 = e[0].a * bx + e[0].b * y + e[0].c;
+                float w1 = e[1].a * bx + e[1].b * y + e[1].c;
+                float w2 = e[2].a * bx + e[2].b * y + e[2].c;
+                float* row = canvas->pixels[y];
+                float* zrow = depth ? depth + (size_t)y * canvas->width : NULL;
+
+                for (int x = bx; x < bx + bw; ++x) {
+                    if (full || (w0 >= 0.0f && w1 >= 0.0f && w2 >= 0.0f)) {
+                        float z = w0 * z0 + w1 * z1 + w2 * z2;
+                        if (!zrow || z < zrow[x]) {
+                            if (zrow) zrow[x] = z;
+                            row[x] = w0 * s0 + w1 * s1 + w2 * s2;
+                        }
+                    }
+                    w0 += e[0].a;
+                    w1 += e[1].a;
+                    w2 += e[2].a;
+                }
+            }
         }
     }
-}
\ No newline at end of file
+}
+
+static vec3_t stream_vertex(const vec3_stream_t* s, int i) {
+    vec3_t v = { .x = s->x[i], .y = s->y[i], .z = s->z[i] };
+    return v;
+}
+
+// Shared by render_solid and render_solid_stream once vertices are projected.
+// eye holds camera-space positions for flat shading (unused with vertex_intensity).
+static void raster_triangles(canvas_t* canvas, const vec3_stream_t* screen, const vec3_stream_t* eye,
+                             int (*triangles)[3], int triangle_count,
+                             const float* vertex_intensity, cull_mode_t cull, float* depth_buffer) {
+    const float* sx = screen->x;
+    const float* sy = screen->y;
+    const float* sz = screen->z;
+    for (int t = 0; t < triangle_count; ++t) {
+        int a = triangles[t][0], b = triangles[t][1], c = triangles[t][2];
+
+        // Reject triangles with a vertex outside the near/far planes
+        if (sz[a] < -1.0f || sz[a] > 1.0f ||
+            sz[b] < -1.0f || sz[b] > 1.0f ||
+            sz[c] < -1.0f || sz[c] > 1.0f) {
+            continue;
+        }
+
+        // Screen y points down, so a front face (counter-clockwise from the camera)
+        // has a negative signed area here
+        if (cull == CULL_BACK) {
+            float area = (sx[b] - sx[a]) * (sy[c] - sy[a]) - (sx[c] - sx[a]) * (sy[b] - sy[a]);
+            if (area >= 0.0f) continue;
+        }
+
+        float ia, ib, ic;
+        if (vertex_intensity) {
+            ia = vertex_intensity[a];
+            ib = vertex_intensity[b];
+            ic = vertex_intensity[c];
+        } else {
+            // Flat shading: how directly the face points at the camera, which sits at
+            // the eye-space origin; faces turned away get 0
+            vec3_t u = { .x = eye->x[b] - eye->x[a], .y = eye->y[b] - eye->y[a], .z = eye->z[b] - eye->z[a] };
+            vec3_t v = { .x = eye->x[c] - eye->x[a], .y = eye->y[c] - eye->y[a], .z = eye->z[c] - eye->z[a] };
+            vec3_t n = { .x = u.y * v.z - u.z * v.y, .y = u.z * v.x - u.x * v.z, .z = u.x * v.y - u.y * v.x };
+            vec3_t to_camera = { .x = -(eye->x[a] + eye->x[b] + eye->x[c]),
+                                 .y = -(eye->y[a] + eye->y[b] + eye->y[c]),
+                                 .z = -(eye->z[a] + eye->z[b] + eye->z[c]) };
+            n = vec3_normalize_fast(n);
+            to_camera = vec3_normalize_fast(to_camera);
+            float facing = n.x * to_camera.x + n.y * to_camera.y + n.z * to_camera.z;
+            ia = ib = ic = facing > 0.0f ? facing : 0.0f;
+        }
+
+        raster_triangle(canvas, depth_buffer, stream_vertex(screen, a), stream_vertex(screen, b),
+                        stream_vertex(screen, c), ia, ib, ic);
+    }
+}
+
+// Fills triangles using the same projection as render_wireframe
+void render_solid(canvas_t* canvas, vec3_t* vertices, int vertex_count, int (*triangles)[3], int triangle_count,
+                  mat4_t model, mat4_t view, mat4_t projection,
+                  const float* vertex_intensity, cull_mode_t cull, float* depth_buffer) {
+    vec3_stream_t* screen = vec3_stream_create(vertex_count);
+    vec3_stream_t* eye = vertex_intensity ? NULL : vec3_stream_create(vertex_count);
+    if (!screen || (!vertex_intensity && !eye)) {
+        vec3_stream_destroy(screen);
+        vec3_stream_destroy(eye);
+        return;
+    }
+
+    // Project each vertex once; flat shading also needs camera-space positions
+    mat4_t model_view = mat4_multiply(view, model);
+    for (int i = 0; i < vertex_count; ++i) {
+        vec3_t s = ndc_to_screen(canvas, project_vertex(vertices[i], model, view, projection));
+        screen->x[i] = s.x;
+        screen->y[i] = s.y;
+        screen->z[i] = s.z;
+        if (eye) {
+            vec3_t e = mat4_transform_vec3(model_view, vertices[i]);
+            eye->x[i] = e.x;
+            eye->y[i] = e.y;
+            eye->z[i] = e.z;
+        }
+    }
+
+    raster_triangles(canvas, screen, eye, triangles, triangle_count, vertex_intensity, cull, depth_buffer);
+    vec3_stream_destroy(screen);
+    vec3_stream_destroy(eye);
+}
+
+// Stream variant: both projections run as batch kernels over the SoA arrays
+void render_solid_stream(canvas_t* canvas, const vec3_stream_t* vertices, int (*triangles)[3], int triangle_count,
+                         mat4_t model, mat4_t view, mat4_t projection,
+                         const float* vertex_intensity, cull_mode_t cull, float* depth_buffer) {
+    vec3_stream_t* screen = vec3_stream_create(vertices->count);
+    vec3_stream_t* eye = vertex_intensity ? NULL : vec3_stream_create(vertices->count);
+    if (!screen || (!vertex_intensity && !eye)) {
+        vec3_stream_destroy(screen);
+        vec3_stream_destroy(eye);
+        return;
+    }
+
+    mat4_t model_view = mat4_multiply(view, model);
+    project_stream(canvas, mat4_multiply(projection, model_view), vertices, screen);
+    if (eye) mat4_transform_stream(model_view, vertices, eye);
+
+    raster_triangles(canvas, screen, eye, triangles, triangle_count, vertex_intensity, cull, depth_buffer);
+    vec3_stream_destroy(screen);
+    vec3_stream_destroy(eye);
+}
@@ -0,0 +1,217 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdlib.h>
+#include "runloop.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <errno.h>
+#include <time.h>
+#endif
+
+// Monotonic clock in seconds
+static double now_seconds(void *clock_user) {
+    (void)clock_user;
+#ifdef _WIN32
+    LARGE_INTEGER freq, counter;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart / (double)freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+#endif
+}
+
+// Sleeps until the monotonic clock reaches deadline (seconds, same base as now_seconds)
+static void sleep_until_seconds(void *clock_user, double deadline) {
+    (void)clock_user;
+#ifdef _WIN32
+    // Sleep takes whole milliseconds and may overshoot by a scheduler tick, so
+    // sleep coarsely to a millisecond short of the deadline and yield the rest
+    for (;;) {
+        double remaining = deadline - now_seconds(NULL);
+        if (remaining <= 0.0) break;
+        if (remaining > 0.002) Sleep((DWORD)((remaining - 0.001) * 1000.0));
+        else Sleep(0);
+    }
+#else
+    struct timespec ts;
+    ts.tv_sec = (time_t)deadline;
+    ts.tv_nsec = (long)((deadline - (double)ts.tv_sec) * 1e9);
+    if (ts.tv_nsec >= 1000000000L) {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000L;
+    }
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+    }
+#endif
+}
+
+static int histogram_bucket(double seconds) {
+    int bucket = (int)(seconds * 1000.0);
+    if (bucket < 0) bucket = 0;
+    if (bucket >= RUNLOOP_HISTOGRAM_BUCKETS) bucket = RUNLOOP_HISTOGRAM_BUCKETS - 1;
+    return bucket;
+}
+
+// Upper edge of the bucket containing the requested percentile (0-100)
+static double histogram_percentile(const unsigned long *histogram, unsigned long total,
+                                   double worst, double percentile) {
+    if (total == 0) return 0.0;
+    if (percentile < 0.0) percentile = 0.0;
+    if (percentile > 100.0) percentile = 100.0;
+
+    double target = percentile / 100.0 * (double)total;
+    unsigned long seen = 0;
+    for (int i = 0; i < RUNLOOP_HISTOGRAM_BUCKETS; ++i) {
+        seen += histogram[i];
+        if ((double)seen >= target && seen > 0) {
+            return i == RUNLOOP_HISTOGRAM_BUCKETS - 1 ? worst : (i + 1) / 1000.0;
+        }
+    }
+    return worst;
+}
+
+runloop_config_t runloop_default_config(void) {
+    runloop_config_t config;
+    config.sim_step = 1.0 / 60.0;
+    config.frame_budget = 1.0 / 60.0;
+    config.max_steps_per_frame = 4;
+    config.max_quality_level = RENDER_QUALITY_MINIMAL;
+    config.recover_frames = 30;
+    return config;
+}
+
+runloop_t* runloop_create(runloop_config_t config,
+                          void (*update)(void *user, double dt),
+                          void (*render)(void *user, double alpha, int quality),
+                          void *user) {
+    if (config.sim_step <= 0.0 || config.frame_budget <= 0.0) return NULL;
+
+    runloop_t *loop = calloc(1, sizeof(runloop_t));
+    if (!loop) return NULL;
+    if (config.max_steps_per_frame < 1) config.max_steps_per_frame = 1;
+    if (config.max_quality_level < 0) config.max_quality_level = 0;
+    if (config.recover_frames < 1) config.recover_frames = 1;
+
+    loop->config = config;
+    loop->update = update;
+    loop->render = render;
+    loop->user = user;
+    loop->now = now_seconds;
+    loop->sleep_until = sleep_until_seconds;
+    return loop;
+}
+
+void runloop_destroy(runloop_t *loop) {
+    free(loop);
+}
+
+void runloop_set_clock(runloop_t *loop, double (*now)(void *clock_user),
+                       void (*sleep_until)(void *clock_user, double deadline), void *clock_user) {
+    loop->now = now;
+    loop->sleep_until = sleep_until;
+    loop->clock_user = clock_user;
+}
+
+void runloop_frame(runloop_t *loop, double elapsed) {
+    if (elapsed < 0.0) elapsed = 0.0;
+    loop->accumulator += elapsed;
+
+    double step = loop->config.sim_step;
+    int steps = 0;
+    while (loop->accumulator >= step && steps < loop->config.max_steps_per_frame) {
+        if (loop->update) loop->update(loop->user, step);
+        loop->accumulator -= step;
+        loop->sim_time += step;
+        steps++;
+    }
+
+    // After a stall, drop the whole-step backlog instead of chasing it frame after frame
+    if (loop->accumulator >= step) {
+        unsigned long behind = (unsigned long)(loop->accumulator / step);
+        loop->dropped_steps += behind;
+        loop->accumulator -= behind * step;
+    }
+
+    if (loop->render) loop->render(loop->user, loop->accumulator / step, loop->quality);
+}
+
+void runloop_record_frame(runloop_t *loop, double frame_time) {
+    loop->histogram[histogram_bucket(frame_time)]++;
+    loop->frame_count++;
+    loop->last_frame_time = frame_time;
+    if (frame_time > loop->worst_frame_time) loop->worst_frame_time = frame_time;
+
+    // Degrade immediately on an overrun, recover only after a sustained fast run
+    if (frame_time > loop->config.frame_budget) {
+        loop->overrun_count++;
+        loop->fast_streak = 0;
+        if (loop->quality < loop->config.max_quality_level) loop->quality++;
+    } else if (frame_time < 0.75 * loop->config.frame_budget) {
+        if (++loop->fast_streak >= loop->config.recover_frames && loop->quality > 0) {
+            loop->quality--;
+            loop->fast_streak = 0;
+        }
+    } else {
+        loop->fast_streak = 0;
+    }
+}
+
+void runloop_record_interval(runloop_t *loop, double interval) {
+    loop->interval_histogram[histogram_bucket(interval)]++;
+    loop->interval_count++;
+    loop->last_interval = interval;
+    if (interval > loop->worst_interval) loop->worst_interval = interval;
+}
+
+void runloop_run(runloop_t *loop, int max_frames) {
+    loop->running = 1;
+    double budget = loop->config.frame_budget;
+    double previous = loop->now(loop->clock_user);
+    double deadline = previous;
+    int frames = 0;
+
+    while (loop->running && (max_frames <= 0 || frames < max_frames)) {
+        double start = loop->now(loop->clock_user);
+        if (frames > 0) runloop_record_interval(loop, start - previous);
+        runloop_frame(loop, start - previous);
+        previous = start;
+
+        double end = loop->now(loop->clock_user);
+        runloop_record_frame(loop, end - start);
+        frames++;
+
+        // Pace against absolute deadlines so sleep overshoot and rounding do not
+        // accumulate; after a stall of more than a frame, resync instead of
+        // rushing a burst of frames to catch up
+        deadline += budget;
+        if (end - deadline > budget) deadline = end;
+        else loop->sleep_until(loop->clock_user, deadline);
+    }
+    loop->running = 0;
+}
+
+void runloop_stop(runloop_t *loop) {
+    loop->running = 0;
+}
+
+const unsigned long* runloop_histogram(const runloop_t *loop, int *bucket_count) {
+    if (bucket_count) *bucket_count = RUNLOOP_HISTOGRAM_BUCKETS;
+    return loop->histogram;
+}
+
+double runloop_frame_percentile(const runloop_t *loop, double percentile) {
+    return histogram_percentile(loop->histogram, loop->frame_count, loop->worst_frame_time, percentile);
+}
+
+const unsigned long* runloop_interval_histogram(const runloop_t *loop, int *bucket_count) {
+    if (bucket_count) *bucket_count = RUNLOOP_HISTOGRAM_BUCKETS;
+    return loop->interval_histogram;
+}
+
+double runloop_interval_percentile(const runloop_t *loop, double percentile) {
+    return histogram_percentile(loop->interval_histogram, loop->interval_count, loop->worst_interval, percentile);
+}
@@ -2,8 +2,7 @@
 #include <stdlib.h>
 #include "math3d.h"
 #include <math.h>
-#ifndef SOCCERBALL_H
-#define SOCCERBALL_H
+#include "soccerball.h"
 
 // Golden ratio constants
 #define C0 0.8090169943749474f    // (1 + sqrt(5)) / 4
@@ -33,7 +32,7 @@ static const vec3_t raw_vertices[60] = {
     { -C1,  C2,  0.5f   ,0,0,0 }, { -C1,  C2, -0.5f,0,0,0 }, { -C1, -C2,  0.5f,0,0,0 }, { -C1, -C2, -0.5f,0,0,0 }
 };
 
-// 32 faces defined by 5 or 6 vertices (but we only need the edges)
+// 32 faces defined by 5 or 6 vertices (-1 terminates pentagons)
 static const int faces[][6] = {
     { 0,  2, 18, 42, 38, 14}, { 1,  3, 17, 41, 37, 13},
     { 2,  0, 12, 36, 40, 16}, { 3,  1, 15, 39, 43, 19},
@@ -114,4 +113,32 @@ void generate_soccer_ball(vec3_t** out_vertices, int* out_vertex_count, int (**o
     *out_edges = e_copy;
     *out_edge_count = edge_count;
 }
-#endif
\ No newline at end of file
+
+// Fan-triangulates the pentagon/hexagon faces for solid rendering
+void generate_soccer_ball_triangles(int (**out_triangles)[3], int* out_triangle_count) {
+    if (!out_triangles || !out_triangle_count) {
+        return;
+    }
+
+    const int face_count = sizeof(faces)/sizeof(faces[0]);
+    const int max_triangles = face_count * 4;  // A hexagon fans into 4 triangles
+    int (*t_copy)[3] = malloc(sizeof(int[3]) * max_triangles);
+    if (!t_copy) {
+        *out_triangle_count = 0;
+        return;
+    }
+
+    int triangle_count = 0;
+    for (int f = 0; f < face_count; ++f) {
+        int n = (faces[f][5] == -1) ? 5 : 6;
+        for (int i = 1; i + 1 < n; ++i) {
+            t_copy[triangle_count][0] = faces[f][0];
+            t_copy[triangle_count][1] = faces[f][i];
+            t_copy[triangle_count][2] = faces[f][i + 1];
+            triangle_count++;
+        }
+    }
+
+    *out_triangles = t_copy;
+    *out_triangle_count = triangle_count;
+}
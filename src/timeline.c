@@ -0,0 +1,171 @@
+#include "timeline.h"
+#include <stdlib.h>
+#include <math.h>
+
+// Earlier events first; at equal times activations run before deactivations
+// so zero-length intervals never leave a curve stuck in the active set
+static int event_before(const timeline_event_t *a, const timeline_event_t *b) {
+    if (a->time != b->time) return a->time < b->time;
+    return a->activate > b->activate;
+}
+
+static int reserve_events(animation_timeline_t *timeline, int extra) {
+    if (timeline->event_count + extra <= timeline->event_capacity) return 1;
+    int capacity = timeline->event_capacity * 2;
+    if (capacity < timeline->event_count + extra) capacity = timeline->event_count + extra;
+    timeline_event_t *grown = realloc(timeline->events, capacity * sizeof(timeline_event_t));
+    if (!grown) return 0;
+    timeline->events = grown;
+    timeline->event_capacity = capacity;
+    return 1;
+}
+
+// Capacity must already be reserved
+static void push_event(animation_timeline_t *timeline, timeline_event_t event) {
+    // Sift up
+    timeline_event_t *heap = timeline->events;
+    int i = timeline->event_count++;
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!event_before(&event, &heap[parent])) break;
+        heap[i] = heap[parent];
+        i = parent;
+    }
+    heap[i] = event;
+}
+
+static timeline_event_t pop_event(animation_timeline_t *timeline) {
+    timeline_event_t *heap = timeline->events;
+    timeline_event_t top = heap[0];
+    timeline_event_t last = heap[--timeline->event_count];
+
+    // Sift down
+    int n = timeline->event_count;
+    int i = 0;
+    while (1) {
+        int child = 2 * i + 1;
+        if (child >= n) break;
+        if (child + 1 < n && event_before(&heap[child + 1], &heap[child])) child++;
+        if (!event_before(&heap[child], &last)) break;
+        heap[i] = heap[child];
+        i = child;
+    }
+    if (n > 0) heap[i] = last;
+    return top;
+}
+
+animation_timeline_t* create_animation_timeline(int initial_capacity) {
+    animation_timeline_t *timeline = malloc(sizeof(animation_timeline_t));
+    if (!timeline) return NULL;
+    if (initial_capacity < 1) initial_capacity = 1;
+
+    timeline->entries = malloc(initial_capacity * sizeof(timeline_entry_t));
+    timeline->active = malloc(initial_capacity * sizeof(int));
+    timeline->events = malloc(2 * initial_capacity * sizeof(timeline_event_t));
+    if (!timeline->entries || !timeline->active || !timeline->events) {
+        free(timeline->entries);
+        free(timeline->active);
+        free(timeline->events);
+        free(timeline);
+        return NULL;
+    }
+    timeline->count = 0;
+    timeline->capacity = initial_capacity;
+    timeline->event_count = 0;
+    timeline->event_capacity = 2 * initial_capacity;
+    timeline->active_count = 0;
+    timeline->current_time = 0.0f;
+    return timeline;
+}
+
+void free_animation_timeline(animation_timeline_t *timeline) {
+    if (!timeline) return;
+    free(timeline->entries);
+    free(timeline->active);
+    free(timeline->events);
+    free(timeline);
+}
+
+int timeline_add_curve(animation_timeline_t *timeline, bezier_curve_t curve, float start_time, float end_time) {
+    if (end_time < start_time) return -1;
+
+    if (timeline->count == timeline->capacity) {
+        int capacity = timeline->capacity * 2;
+        timeline_entry_t *entries = realloc(timeline->entries, capacity * sizeof(timeline_entry_t));
+        if (!entries) return -1;
+        timeline->entries = entries;
+        int *active = realloc(timeline->active, capacity * sizeof(int));
+        if (!active) return -1;
+        timeline->active = active;
+        timeline->capacity = capacity;
+    }
+
+    if (!reserve_events(timeline, 2)) return -1;
+
+    int id = timeline->count;
+    timeline_event_t start = { start_time, id, 1 };
+    timeline_event_t end = { end_time, id, 0 };
+    push_event(timeline, start);
+    push_event(timeline, end);
+
+    timeline_entry_t *entry = &timeline->entries[id];
+    entry->curve = curve;
+    entry->start_time = start_time;
+    entry->end_time = end_time;
+    entry->active_slot = -1;
+    timeline->count++;
+    return id;
+}
+
+void timeline_advance(animation_timeline_t *timeline, float time) {
+    if (time < timeline->current_time) return;
+    timeline->current_time = time;
+
+    while (timeline->event_count > 0 && timeline->events[0].time <= time) {
+        timeline_event_t event = pop_event(timeline);
+        timeline_entry_t *entry = &timeline->entries[event.curve_id];
+
+        if (event.activate) {
+            if (entry->active_slot < 0 && entry->end_time > entry->start_time) {
+                entry->active_slot = timeline->active_count;
+                timeline->active[timeline->active_count++] = event.curve_id;
+            }
+        } else if (entry->active_slot >= 0) {
+            // Swap-remove from the active list
+            int last = timeline->active[--timeline->active_count];
+            timeline->active[entry->active_slot] = last;
+            timeline->entries[last].active_slot = entry->active_slot;
+            entry->active_slot = -1;
+        }
+    }
+}
+
+void timeline_update(animation_timeline_t *timeline, float delta_time) {
+    timeline_advance(timeline, timeline->current_time + delta_time);
+}
+
+const int* timeline_active_curves(const animation_timeline_t *timeline, int *count) {
+    *count = timeline->active_count;
+    return timeline->active;
+}
+
+vec3_t timeline_sample(const animation_timeline_t *timeline, int curve_id, float time) {
+    const timeline_entry_t *entry = &timeline->entries[curve_id];
+    const bezier_curve_t *curve = &entry->curve;
+    if (time < entry->start_time) time = entry->start_time;
+
+    if (time >= entry->end_time) {
+        // Hold where the curve got to by the end of its interval. A looping curve
+        // that ends on a whole cycle finished at p3; sampling there would wrap to p0.
+        // end - start is rarely an exact multiple in floats, so allow a small slack
+        float local_time = entry->end_time - entry->start_time;
+        if (curve->loop && curve->duration > 0.0f && local_time > 0.0f) {
+            float cycles = roundf(local_time / curve->duration);
+            if (cycles >= 1.0f && fabsf(local_time - cycles * curve->duration) <= 1e-4f * curve->duration) {
+                return vec3_bezier(curve->p0, curve->p1, curve->p2, curve->p3, 1.0f);
+            }
+        }
+        return sample_bezier_curve(curve, local_time);
+    }
+    return sample_bezier_curve(curve, time - entry->start_time);
+}
@@ -0,0 +1,141 @@
+#include <stdlib.h>
+#include <math.h>
+#include "viewport.h"
+
+static viewport_mask_t* mask_alloc(int width, int height, int span_capacity) {
+    if (width <= 0 || height <= 0) return NULL;
+
+    viewport_mask_t *mask = malloc(sizeof(viewport_mask_t));
+    if (!mask) return NULL;
+    mask->width = width;
+    mask->height = height;
+    mask->row_start = malloc((height + 1) * sizeof(int));
+    mask->spans = malloc((span_capacity > 0 ? span_capacity : 1) * sizeof(span_t));
+    if (!mask->row_start || !mask->spans) {
+        viewport_mask_destroy(mask);
+        return NULL;
+    }
+    return mask;
+}
+
+// Records the bounding box once the spans are filled in; returns mask
+static viewport_mask_t* mask_finish(viewport_mask_t *mask) {
+    mask->xmin = mask->ymin = 0;
+    mask->xmax = mask->ymax = -1;
+    int first = 1;
+    for (int y = 0; y < mask->height; ++y) {
+        for (int i = mask->row_start[y]; i < mask->row_start[y + 1]; ++i) {
+            if (first || mask->spans[i].xmin < mask->xmin) mask->xmin = mask->spans[i].xmin;
+            if (first || mask->spans[i].xmax > mask->xmax) mask->xmax = mask->spans[i].xmax;
+            if (first) mask->ymin = y;
+            mask->ymax = y;
+            first = 0;
+        }
+    }
+    return mask;
+}
+
+viewport_mask_t* viewport_mask_circle(int width, int height) {
+    viewport_mask_t *mask = mask_alloc(width, height, height);
+    if (!mask) return NULL;
+
+    // Integer maths so the span edges match clip_to_circular_viewport exactly
+    int cx = width / 2;
+    int cy = height / 2;
+    int radius = (width < height ? width : height) / 2;
+    int count = 0;
+
+    for (int y = 0; y < height; ++y) {
+        mask->row_start[y] = count;
+        int dy = y - cy;
+        int rem = radius * radius - dy * dy;
+        if (rem < 0) continue;
+
+        int half = (int)sqrtf((float)rem);
+        while (half * half > rem) half--;
+        while ((half + 1) * (half + 1) <= rem) half++;
+
+        int xmin = cx - half < 0 ? 0 : cx - half;
+        int xmax = cx + half > width - 1 ? width - 1 : cx + half;
+        if (xmin > xmax) continue;
+        mask->spans[count].xmin = xmin;
+        mask->spans[count].xmax = xmax;
+        count++;
+    }
+    mask->row_start[height] = count;
+    return mask_finish(mask);
+}
+
+viewport_mask_t* viewport_mask_ellipse(int width, int height, float cx, float cy, float rx, float ry) {
+    viewport_mask_t *mask = mask_alloc(width, height, height);
+    if (!mask) return NULL;
+
+    int count = 0;
+    for (int y = 0; y < height; ++y) {
+        mask->row_start[y] = count;
+        if (rx <= 0.0f || ry <= 0.0f) continue;
+        float t = (y - cy) / ry;
+        if (t * t > 1.0f) continue;
+
+        float half = rx * sqrtf(1.0f - t * t);
+        int xmin = (int)ceilf(cx - half);
+        int xmax = (int)floorf(cx + half);
+        if (xmin < 0) xmin = 0;
+        if (xmax > width - 1) xmax = width - 1;
+        if (xmin > xmax) continue;
+        mask->spans[count].xmin = xmin;
+        mask->spans[count].xmax = xmax;
+        count++;
+    }
+    mask->row_start[height] = count;
+    return mask_finish(mask);
+}
+
+viewport_mask_t* viewport_mask_from_stencil(int width, int height, const unsigned char *stencil) {
+    if (!stencil) return NULL;
+
+    // Count runs first so the span array is allocated once
+    int total = 0;
+    for (int y = 0; y < height; ++y) {
+        const unsigned char *row = stencil + (size_t)y * width;
+        for (int x = 0; x < width; ++x) {
+            if (row[x] && (x == 0 || !row[x - 1])) total++;
+        }
+    }
+
+    viewport_mask_t *mask = mask_alloc(width, height, total);
+    if (!mask) return NULL;
+
+    int count = 0;
+    for (int y = 0; y < height; ++y) {
+        mask->row_start[y] = count;
+        const unsigned char *row = stencil + (size_t)y * width;
+        int x = 0;
+        while (x < width) {
+            while (x < width && !row[x]) x++;
+            if (x == width) break;
+            mask->spans[count].xmin = x;
+            while (x < width && row[x]) x++;
+            mask->spans[count].xmax = x - 1;
+            count++;
+        }
+    }
+    mask->row_start[height] = count;
+    return mask_finish(mask);
+}
+
+void viewport_mask_destroy(viewport_mask_t *mask) {
+    if (mask) {
+        free(mask->row_start);
+        free(mask->spans);
+        free(mask);
+    }
+}
+
+int viewport_mask_contains(const viewport_mask_t *mask, int x, int y) {
+    if (y < 0 || y >= mask->height) return 0;
+    for (int i = mask->row_start[y]; i < mask->row_start[y + 1]; ++i) {
+        if (x >= mask->spans[i].xmin && x <= mask->spans[i].xmax) return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,284 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "canvas.h"
+#include "test_util.h"
+
+#define WIDTH 67
+#define HEIGHT 45
+
+// Per-pixel inside tests, written from each shape's definition rather than its spans
+
+typedef struct {
+    int kind;
+    float cx, cy, rx, ry;
+    const unsigned char* stencil;
+} shape_t;
+
+enum { SHAPE_CIRCLE, SHAPE_ELLIPSE, SHAPE_STENCIL };
+
+static int shape_contains(const shape_t* shape, int x, int y) {
+    switch (shape->kind) {
+    case SHAPE_CIRCLE: {
+        // Same circle as clip_to_circular_viewport
+        int radius = (WIDTH < HEIGHT ? WIDTH : HEIGHT) / 2;
+        int dx = x - WIDTH / 2, dy = y - HEIGHT / 2;
+        return dx * dx + dy * dy <= radius * radius;
+    }
+    case SHAPE_ELLIPSE: {
+        float u = (x - shape->cx) / shape->rx, v = (y - shape->cy) / shape->ry;
+        return u * u + v * v <= 1.0f;
+    }
+    default:
+        return shape->stencil[y * WIDTH + x] != 0;
+    }
+}
+
+// A ring with a bar through it and a checkered block: rows with several spans
+static void make_stencil(unsigned char* stencil) {
+    for (int y = 0; y < HEIGHT; y++) {
+        for (int x = 0; x < WIDTH; x++) {
+            float dx = x - 30.0f, dy = y - 22.0f;
+            float d2 = dx * dx + dy * dy;
+            int ring = d2 >= 100.0f && d2 <= 400.0f;
+            int bar = y >= 20 && y <= 23 && x >= 5 && x <= 60;
+            int checker = x >= 52 && y < 15 && ((x / 3 + y / 3) & 1);
+            stencil[y * WIDTH + x] = (unsigned char)(ring || bar || checker);
+        }
+    }
+}
+
+// Draws the same lines with and without the mask; the masked canvas must equal
+// the unmasked one on the pixels inside the shape and stay zero outside.
+// Lines that never cross the shape's edge would prove nothing, so that counts too.
+static int masked_mismatches(const viewport_mask_t* mask, const shape_t* shape, float thickness) {
+    canvas_t* masked = canvas_create(WIDTH, HEIGHT);
+    canvas_t* full = canvas_create(WIDTH, HEIGHT);
+    canvas_clear(masked);
+    canvas_clear(full);
+    for (int i = 0; i < 300; i++) {
+        float range = i % 4 == 0 ? 3.0f : 1.4f;
+        float x0 = (random_unit() * range - (range - 1.0f) / 2) * WIDTH;
+        float y0 = (random_unit() * range - (range - 1.0f) / 2) * HEIGHT;
+        float x1 = (random_unit() * range - (range - 1.0f) / 2) * WIDTH;
+        float y1 = (random_unit() * range - (range - 1.0f) / 2) * HEIGHT;
+        if (i % 9 == 0) y1 = y0;
+        if (i % 13 == 0) x1 = x0;
+        draw_line_f_masked(masked, mask, x0, y0, x1, y1, thickness);
+        draw_line_f(full, x0, y0, x1, y1, thickness);
+    }
+
+    int mismatched = 0, lit_inside = 0, lit_outside = 0;
+    for (int y = 0; y < HEIGHT; y++) {
+        for (int x = 0; x < WIDTH; x++) {
+            int inside = shape_contains(shape, x, y);
+            float want = inside ? full->pixels[y][x] : 0.0f;
+            mismatched += masked->pixels[y][x] != want;
+            if (full->pixels[y][x] != 0.0f) {
+                if (inside) lit_inside++;
+                else lit_outside++;
+            }
+        }
+    }
+    canvas_destroy(full);
+    canvas_destroy(masked);
+    return mismatched + (lit_inside == 0) + (lit_outside == 0);
+}
+
+static void test_masked_lines(void) {
+    unsigned char* stencil = malloc(WIDTH * HEIGHT);
+    make_stencil(stencil);
+    canvas_t* canvas = canvas_create(WIDTH, HEIGHT);
+
+    const viewport_mask_t* cached = canvas_viewport_mask(canvas);
+    check(cached && cached == canvas_viewport_mask(canvas), "canvas viewport mask is built once");
+
+    viewport_mask_t* ellipse = viewport_mask_ellipse(WIDTH, HEIGHT, 30.3f, 20.7f, 24.1f, 13.4f);
+    viewport_mask_t* stenciled = viewport_mask_from_stencil(WIDTH, HEIGHT, stencil);
+    shape_t shapes[3] = {
+        { SHAPE_CIRCLE, 0, 0, 0, 0, NULL },
+        { SHAPE_ELLIPSE, 30.3f, 20.7f, 24.1f, 13.4f, NULL },
+        { SHAPE_STENCIL, 0, 0, 0, 0, stencil },
+    };
+    const viewport_mask_t* masks[3] = { cached, ellipse, stenciled };
+    static const char* names[3][2] = {
+        { "thin lines match the circle per pixel", "capsules match the circle per pixel" },
+        { "thin lines match the ellipse per pixel", "capsules match the ellipse per pixel" },
+        { "thin lines match the stencil per pixel", "capsules match the stencil per pixel" },
+    };
+    for (int s = 0; s < 3; s++) {
+        int outside = 0;
+        for (int y = 0; y < HEIGHT; y++) {
+            for (int x = 0; x < WIDTH; x++) {
+                outside += viewport_mask_contains(masks[s], x, y) != shape_contains(&shapes[s], x, y);
+            }
+        }
+        check(outside == 0, "mask spans agree with the shape");
+        check(masked_mismatches(masks[s], &shapes[s], 1.0f) == 0, names[s][0]);
+        check(masked_mismatches(masks[s], &shapes[s], 3.5f) == 0, names[s][1]);
+    }
+
+    // A mask built for another size is rejected rather than indexed out of range
+    viewport_mask_t* small = viewport_mask_circle(WIDTH - 1, HEIGHT);
+    canvas_clear(canvas);
+    draw_line_f_masked(canvas, small, 0.0f, 0.0f, WIDTH - 1.0f, HEIGHT - 1.0f, 1.0f);
+    draw_line_f_masked(canvas, small, 0.0f, 0.0f, WIDTH - 1.0f, HEIGHT - 1.0f, 4.0f);
+    int lit = 0;
+    for (int y = 0; y < HEIGHT; y++) {
+        for (int x = 0; x < WIDTH; x++) lit += canvas->pixels[y][x] != 0.0f;
+    }
+    check(lit == 0, "mismatched mask draws nothing");
+
+    viewport_mask_destroy(small);
+    viewport_mask_destroy(stenciled);
+    viewport_mask_destroy(ellipse);
+    canvas_destroy(canvas);
+    free(stencil);
+}
+
+// Capsule coverage from its definition: outer radius minus the distance to the
+// segment, clamped to [0, 1]
+static float capsule_coverage(float px, float py, float x0, float y0, float x1, float y1, float thickness) {
+    float dx = x1 - x0, dy = y1 - y0;
+    float len_sq = dx * dx + dy * dy;
+    float t = len_sq > 0.0f ? ((px - x0) * dx + (py - y0) * dy) / len_sq : 0.0f;
+    t = t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t);
+    float ex = px - (x0 + t * dx), ey = py - (y0 + t * dy);
+    float coverage = thickness * 0.5f + 0.5f - sqrtf(ex * ex + ey * ey);
+    return coverage < 0.0f ? 0.0f : (coverage > 1.0f ? 1.0f : coverage);
+}
+
+// Draws one capsule on a cleared canvas; returns the largest difference from the
+// reference coverage and reports the coverage range and the pixels it touched
+static float capsule_error(canvas_t* canvas, float x0, float y0, float x1, float y1, float thickness,
+                           float* lo, float* hi, int* lit) {
+    canvas_clear(canvas);
+    draw_line_f(canvas, x0, y0, x1, y1, thickness);
+    float worst = 0.0f;
+    *lo = INFINITY;
+    *hi = -INFINITY;
+    *lit = 0;
+    for (int y = 0; y < canvas->height; y++) {
+        for (int x = 0; x < canvas->width; x++) {
+            float value = canvas->pixels[y][x];
+            float error = fabsf(value - capsule_coverage((float)x, (float)y, x0, y0, x1, y1, thickness));
+            if (error > worst) worst = error;
+            if (value < *lo) *lo = value;
+            if (value > *hi) *hi = value;
+            *lit += value != 0.0f;
+        }
+    }
+    return worst;
+}
+
+static void test_capsules(void) {
+    canvas_t* canvas = canvas_create(WIDTH, HEIGHT);
+    canvas_t* mirrored = canvas_create(WIDTH, HEIGHT);
+    float lo, hi;
+    int lit;
+
+    // Symmetry: a horizontal capsule centred on x = 33, y = 22 mirrors both ways,
+    // a diagonal one transposes, and swapping the endpoints changes nothing
+    capsule_error(canvas, 13.0f, 22.0f, 53.0f, 22.0f, 6.0f, &lo, &hi, &lit);
+    float asymmetry = 0.0f;
+    for (int y = 0; y < HEIGHT; y++) {
+        for (int x = 0; x < WIDTH; x++) {
+            float a = fabsf(canvas->pixels[y][x] - canvas->pixels[y][66 - x]);
+            float b = fabsf(canvas->pixels[y][x] - canvas->pixels[44 - y][x]);
+            if (a > asymmetry) asymmetry = a;
+            if (b > asymmetry) asymmetry = b;
+        }
+    }
+    check(lit > 0 && asymmetry < 1e-5f, "horizontal capsule is mirror symmetric");
+
+    capsule_error(canvas, 8.5f, 6.5f, 36.5f, 34.5f, 5.0f, &lo, &hi, &lit);
+    asymmetry = 0.0f;
+    for (int y = 0; y < HEIGHT; y++) {
+        for (int x = 0; x < HEIGHT; x++) {
+            float a = fabsf(canvas->pixels[y][x + 2] - canvas->pixels[x][y + 2]);
+            if (a > asymmetry) asymmetry = a;
+        }
+    }
+    check(asymmetry < 1e-5f, "diagonal capsule is symmetric about its axis");
+
+    canvas_clear(mirrored);
+    draw_line_f(mirrored, 36.5f, 34.5f, 8.5f, 6.5f, 5.0f);
+    asymmetry = 0.0f;
+    for (int y = 0; y < HEIGHT; y++) {
+        for (int x = 0; x < WIDTH; x++) {
+            float a = fabsf(canvas->pixels[y][x] - mirrored->pixels[y][x]);
+            if (a > asymmetry) asymmetry = a;
+        }
+    }
+    check(asymmetry < 1e-5f, "endpoint order does not matter");
+
+    // Zero-length capsules are round dots: full in the middle, fading over one pixel
+    float error = capsule_error(canvas, 30.0f, 20.0f, 30.0f, 20.0f, 7.0f, &lo, &hi, &lit);
+    check(error < 1e-4f, "zero-length capsule matches the dot coverage");
+    check(canvas->pixels[20][30] == 1.0f && canvas->pixels[20][34] == 0.0f && canvas->pixels[20][33] > 0.0f,
+          "dot is full at its centre and ends at radius + 0.5");
+    error = capsule_error(canvas, 30.25f, 20.75f, 30.25f, 20.75f, 2.0f, &lo, &hi, &lit);
+    check(error < 1e-4f && lit > 0 && hi <= 1.0f, "small off-centre dot matches the dot coverage");
+
+    // Capsules hanging over every edge keep the visible part's coverage
+    static const float clipped[][5] = {
+        { -6.0f, 10.0f, 20.0f, 30.0f, 9.0f }, { 60.0f, -4.0f, 75.0f, 30.0f, 6.0f },
+        { 10.0f, 40.0f, 50.0f, 52.0f, 8.0f }, { -20.0f, -20.0f, 90.0f, 70.0f, 4.0f },
+        { 0.0f, 0.0f, 0.0f, 0.0f, 5.0f }, { 66.0f, 44.0f, 66.0f, 44.0f, 5.0f },
+        { -1e4f, 22.0f, 1e4f, 22.5f, 3.0f }, { -50.0f, -50.0f, -40.0f, -30.0f, 6.0f },
+    };
+    float worst = 0.0f;
+    int empty_inside = 0, drew_outside = 0;
+    for (int k = 0; k < (int)(sizeof(clipped) / sizeof(clipped[0])); k++) {
+        const float* c = clipped[k];
+        error = capsule_error(canvas, c[0], c[1], c[2], c[3], c[4], &lo, &hi, &lit);
+        if (error > worst) worst = error;
+        if (k < 7 && lit == 0) empty_inside++;
+        if (k == 7 && lit != 0) drew_outside++;
+    }
+    check(worst < 1e-4f, "capsules clipped at the canvas edges keep their coverage");
+    check(empty_inside == 0 && drew_outside == 0, "clipped capsules draw exactly their visible part");
+
+    // The canvas accumulates, so coverage bounds are per capsule: where the end caps
+    // and the slab overlap (short capsules, shorter than their width) no pixel is
+    // counted twice, and a mask splitting rows into spans does not either
+    float range_lo = 0.0f, range_hi = 0.0f;
+    worst = 0.0f;
+    for (int i = 0; i < 200; i++) {
+        float x0 = 5.0f + random_unit() * (WIDTH - 10), y0 = 5.0f + random_unit() * (HEIGHT - 10);
+        float length = random_unit() * 8.0f, angle = random_unit() * 6.2831853f;
+        float thickness = 1.5f + random_unit() * 10.0f;
+        error = capsule_error(canvas, x0, y0, x0 + length * cosf(angle), y0 + length * sinf(angle), thickness,
+                              &lo, &hi, &lit);
+        if (error > worst) worst = error;
+        if (lo < range_lo) range_lo = lo;
+        if (hi > range_hi) range_hi = hi;
+    }
+    check(range_lo >= 0.0f && range_hi <= 1.0f, "overlapping caps keep coverage within [0, 1]");
+    check(worst < 1e-4f, "short capsules match the reference coverage");
+
+    unsigned char* stencil = malloc(WIDTH * HEIGHT);
+    for (int k = 0; k < WIDTH * HEIGHT; k++) stencil[k] = (unsigned char)((k % WIDTH) % 4 != 3);
+    viewport_mask_t* columns = viewport_mask_from_stencil(WIDTH, HEIGHT, stencil);
+    canvas_clear(canvas);
+    draw_line_f_masked(canvas, columns, 20.0f, 20.0f, 24.0f, 23.0f, 12.0f);
+    hi = 0.0f;
+    for (int y = 0; y < HEIGHT; y++) {
+        for (int x = 0; x < WIDTH; x++) hi = canvas->pixels[y][x] > hi ? canvas->pixels[y][x] : hi;
+    }
+    check(hi == 1.0f, "rows split into many spans are covered once");
+    viewport_mask_destroy(columns);
+    free(stencil);
+
+    canvas_destroy(mirrored);
+    canvas_destroy(canvas);
+}
+
+int main() {
+    random_seed(31u);
+    test_masked_lines();
+    test_capsules();
+
+    return test_report("test_canvas");
+}
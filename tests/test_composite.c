@@ -0,0 +1,199 @@
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include "canvas.h"
+#include "test_util.h"
+
+// Built twice by the Makefile: with the SSE kernels and with -DCOMPOSITE_SCALAR
+#ifdef COMPOSITE_SCALAR
+#define TEST_NAME "test_composite (scalar)"
+#else
+#define TEST_NAME "test_composite"
+#endif
+
+#define HEIGHT 6
+
+static void fill_random(canvas_t* canvas) {
+    for (int y = 0; y < canvas->height; y++) {
+        for (int x = 0; x < canvas->width; x++) canvas->pixels[y][x] = 2.0f * random_unit() - 0.5f;
+    }
+}
+
+static void copy_canvas(canvas_t* dst, const canvas_t* src) {
+    for (int y = 0; y < src->height; y++) {
+        memcpy(dst->pixels[y], src->pixels[y], (size_t)src->width * sizeof(float));
+    }
+}
+
+static int canvases_equal(const canvas_t* a, const canvas_t* b) {
+    for (int y = 0; y < a->height; y++) {
+        if (memcmp(a->pixels[y], b->pixels[y], (size_t)a->width * sizeof(float)) != 0) return 0;
+    }
+    return 1;
+}
+
+enum { OP_ADD, OP_MAX, OP_BLEND, OP_SCALE };
+
+// Per-pixel reference over [x0, x1) x [y0, y1), already clipped
+static void reference_op(int op, canvas_t* dst, const canvas_t* src, float value, int x0, int y0, int x1, int y1) {
+    for (int y = y0; y < y1; y++) {
+        float* d = dst->pixels[y];
+        const float* s = src->pixels[y];
+        for (int x = x0; x < x1; x++) {
+            switch (op) {
+            case OP_ADD: d[x] += s[x]; break;
+            case OP_MAX: d[x] = d[x] > s[x] ? d[x] : s[x]; break;
+            case OP_BLEND: d[x] += value * (s[x] - d[x]); break;
+            case OP_SCALE: d[x] *= value; break;
+            }
+        }
+    }
+}
+
+static void run_op(int op, canvas_t* dst, const canvas_t* src, float value, const canvas_rect_t* region) {
+    switch (op) {
+    case OP_ADD: canvas_add(dst, src, region); break;
+    case OP_MAX: canvas_max(dst, src, region); break;
+    case OP_BLEND: canvas_blend(dst, src, value, region); break;
+    case OP_SCALE: canvas_scale(dst, value, region); break;
+    }
+}
+
+// Odd widths leave a scalar tail after the four-wide kernel; regions at odd x
+// start the kernel unaligned. src is wider and taller than dst to test clipping.
+static void test_kernels(void) {
+    static const char* names[4] = { "canvas_add", "canvas_max", "canvas_blend", "canvas_scale" };
+    static const int widths[] = { 1, 3, 5, 7, 9, 13, 31 };
+    for (int op = OP_ADD; op <= OP_SCALE; op++) {
+        int mismatched = 0;
+        for (int w = 0; w < (int)(sizeof(widths) / sizeof(widths[0])); w++) {
+            int width = widths[w];
+            canvas_t* dst = canvas_create(width, HEIGHT);
+            canvas_t* src = canvas_create(width + 3, HEIGHT + 2);
+            canvas_t* expected = canvas_create(width, HEIGHT);
+            float value = op == OP_BLEND ? 0.3f : 0.85f;
+
+            // Whole canvas
+            fill_random(dst);
+            fill_random(src);
+            copy_canvas(expected, dst);
+            run_op(op, dst, src, value, NULL);
+            reference_op(op, expected, src, value, 0, 0, width, HEIGHT);
+            mismatched += !canvases_equal(dst, expected);
+
+            // Every region starting at an odd column, including ones past the right edge
+            for (int x = 1; x < width; x += 2) {
+                for (int rw = 1; rw <= width + 2; rw += 3) {
+                    canvas_rect_t region = { x, 1, rw, HEIGHT - 2 };
+                    int x1 = x + rw < width ? x + rw : width;
+                    run_op(op, dst, src, value, &region);
+                    reference_op(op, expected, src, value, x, 1, x1, HEIGHT - 1);
+                    mismatched += !canvases_equal(dst, expected);
+                }
+            }
+
+            canvas_destroy(expected);
+            canvas_destroy(src);
+            canvas_destroy(dst);
+        }
+        char what[64];
+        snprintf(what, sizeof(what), "%s matches the scalar reference", names[op]);
+        check(mismatched == 0, what);
+    }
+}
+
+// In-place scrolls in every direction match a blit from an untouched copy
+static void test_blit_in_place(void) {
+    static const int offsets[][2] = { { 3, 0 }, { -3, 0 }, { 0, 2 }, { 0, -2 }, { 2, 1 }, { -2, -1 },
+                                      { 1, -2 }, { -1, 2 }, { 0, 0 } };
+    int width = 11;
+    canvas_t* canvas = canvas_create(width, HEIGHT);
+    canvas_t* copy = canvas_create(width, HEIGHT);
+    canvas_t* expected = canvas_create(width, HEIGHT);
+    int mismatched = 0;
+    for (int k = 0; k < (int)(sizeof(offsets) / sizeof(offsets[0])); k++) {
+        int dx = offsets[k][0], dy = offsets[k][1];
+        fill_random(canvas);
+        copy_canvas(copy, canvas);
+        copy_canvas(expected, canvas);
+        canvas_blit(expected, copy, dx, dy);
+        canvas_blit(canvas, canvas, dx, dy);
+        mismatched += !canvases_equal(canvas, expected);
+
+        // And the reference itself: shifted pixels come from the copy, the rest are untouched
+        int wrong = 0;
+        for (int y = 0; y < HEIGHT; y++) {
+            for (int x = 0; x < width; x++) {
+                int sx = x - dx, sy = y - dy;
+                int inside = sx >= 0 && sy >= 0 && sx < width && sy < HEIGHT;
+                float want = inside ? copy->pixels[sy][sx] : copy->pixels[y][x];
+                wrong += expected->pixels[y][x] != want;
+            }
+        }
+        mismatched += wrong != 0;
+    }
+    check(mismatched == 0, "in-place blit matches a blit from a copy in every direction");
+    canvas_destroy(expected);
+    canvas_destroy(copy);
+    canvas_destroy(canvas);
+}
+
+// Offsets and regions far outside the canvas clip to nothing instead of wrapping
+static void test_extreme_offsets(void) {
+    int width = 9;
+    canvas_t* dst = canvas_create(width, HEIGHT);
+    canvas_t* src = canvas_create(width, HEIGHT);
+    canvas_t* expected = canvas_create(width, HEIGHT);
+    fill_random(dst);
+    fill_random(src);
+    copy_canvas(expected, dst);
+
+    static const int offsets[][2] = { { INT_MIN, 0 }, { INT_MAX, 0 }, { 0, INT_MIN }, { 0, INT_MAX },
+                                      { INT_MIN, INT_MIN }, { INT_MAX, INT_MAX }, { -9, 0 }, { 9, 0 },
+                                      { 0, -HEIGHT }, { 0, HEIGHT } };
+    for (int k = 0; k < (int)(sizeof(offsets) / sizeof(offsets[0])); k++) {
+        canvas_blit(dst, src, offsets[k][0], offsets[k][1]);
+    }
+    check(canvases_equal(dst, expected), "blits entirely outside dst draw nothing");
+
+    canvas_blit(dst, src, -(width - 2), -(HEIGHT - 1));
+    int partial = dst->pixels[0][0] == src->pixels[HEIGHT - 1][width - 2] &&
+                  dst->pixels[0][1] == src->pixels[HEIGHT - 1][width - 1] &&
+                  dst->pixels[0][2] == expected->pixels[0][2] && dst->pixels[1][0] == expected->pixels[1][0];
+    check(partial, "negative offsets copy only the bottom-right corner");
+    copy_canvas(dst, expected);
+
+    const canvas_rect_t regions[] = {
+        { INT_MAX, 0, INT_MAX, HEIGHT }, { 0, INT_MAX, width, INT_MAX }, { INT_MIN, 0, 5, HEIGHT },
+        { 0, INT_MIN, width, 5 }, { 2, 0, -3, HEIGHT }, { 0, 2, width, 0 }, { width, 0, 5, HEIGHT },
+    };
+    for (int k = 0; k < (int)(sizeof(regions) / sizeof(regions[0])); k++) {
+        canvas_add(dst, src, &regions[k]);
+        canvas_max(dst, src, &regions[k]);
+        canvas_blend(dst, src, 0.5f, &regions[k]);
+        canvas_scale(dst, 0.5f, &regions[k]);
+    }
+    check(canvases_equal(dst, expected), "regions outside the canvas or with no area touch nothing");
+
+    // A region from far left to far right covers the whole canvas without wrapping
+    canvas_rect_t huge = { INT_MIN / 2, -1, INT_MAX, HEIGHT + 2 };
+    canvas_scale(dst, 0.0f, &huge);
+    int cleared = 1;
+    for (int y = 0; y < HEIGHT; y++) {
+        for (int x = 0; x < width; x++) cleared &= dst->pixels[y][x] == 0.0f;
+    }
+    check(cleared, "a huge region clips to the whole canvas");
+
+    canvas_destroy(expected);
+    canvas_destroy(src);
+    canvas_destroy(dst);
+}
+
+int main() {
+    random_seed(7u);
+    test_kernels();
+    test_blit_in_place();
+    test_extreme_offsets();
+
+    return test_report(TEST_NAME);
+}
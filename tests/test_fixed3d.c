@@ -0,0 +1,160 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "fixed3d.h"
+#include "soccerball.h"
+#include "test_util.h"
+
+#define WIDTH 400
+#define HEIGHT 400
+
+static void test_conversions(void) {
+    check(fix16_from_float(1.5f) == 3 * FIX16_ONE / 2, "1.5 converts exactly");
+    check(fix16_from_float(-0.25f) == -FIX16_ONE / 4, "negative values convert exactly");
+    check(fix16_to_float(fix16_from_float(3.0f)) == 3.0f, "round trip");
+    check(fix16_mul(fix16_from_float(2.5f), fix16_from_float(-4.0f)) == fix16_from_float(-10.0f), "multiply");
+}
+
+// The documented bound: on the soccer scene (|coordinates| <= 8, clip w >= 1)
+// NDC agrees with the float path within 1e-3 and pixels within one
+static void test_error_bound(void) {
+    vec3_t* vertices = NULL;
+    int vertex_count = 0;
+    int (*edges)[2] = NULL;
+    int edge_count = 0;
+    generate_soccer_ball(&vertices, &vertex_count, &edges, &edge_count);
+
+    float aspect_ratio = (float)WIDTH / HEIGHT;
+    mat4_t proj = mat4_frustum_asymmetric(-aspect_ratio, aspect_ratio, -1.0f, 1.0f, 1.0f, 10.0f);
+    mat4_t view = mat4_translate(0.0f, 0.0f, -4.0f);
+    fvec3_t* fixed_vertices = malloc(vertex_count * sizeof(fvec3_t));
+    for (int i = 0; i < vertex_count; i++) fixed_vertices[i] = fvec3_from_vec3(vertices[i]);
+
+    float worst_ndc = 0.0f;
+    int worst_pixel = 0, projected = 0;
+    for (int frame = 0; frame < 60; frame++) {
+        mat4_t model = mat4_rotate_xyz(0.1f * frame, frame * (6.2831853f / 60), 0.05f * frame);
+        mat4_t mvp = mat4_multiply(proj, mat4_multiply(view, model));
+        fmat4_t fmvp = fmat4_multiply(fmat4_from_mat4(proj),
+                                      fmat4_multiply(fmat4_from_mat4(view), fmat4_from_mat4(model)));
+
+        for (int i = 0; i < vertex_count; i++) {
+            vec3_t ndc = mat4_transform_vec3(mvp, vertices[i]);
+            fvec3_t fndc = fmat4_transform_fvec3(fmvp, fixed_vertices[i]);
+            float dx = fabsf(fix16_to_float(fndc.x) - ndc.x);
+            float dy = fabsf(fix16_to_float(fndc.y) - ndc.y);
+            if (dx > worst_ndc) worst_ndc = dx;
+            if (dy > worst_ndc) worst_ndc = dy;
+
+            int sx, sy;
+            if (!fproject_to_screen(fmvp, fixed_vertices[i], WIDTH, HEIGHT, &sx, &sy)) continue;
+            projected++;
+            int px = abs(sx - (int)((ndc.x + 1.0f) * 0.5f * WIDTH));
+            int py = abs(sy - (int)((1.0f - (ndc.y + 1.0f) * 0.5f) * HEIGHT));
+            if (px > worst_pixel) worst_pixel = px;
+            if (py > worst_pixel) worst_pixel = py;
+        }
+    }
+    check(projected == 60 * vertex_count, "every soccer vertex is in front of the camera");
+    check(worst_ndc < 1e-3f, "NDC within 1e-3 of the float path");
+    check(worst_pixel <= 1, "screen coordinates within one pixel of the float path");
+
+    free(fixed_vertices);
+    free(edges);
+    free(vertices);
+}
+
+static void test_near_and_far(void) {
+    // Identity-like mvp with w taken from z: w = z
+    fmat4_t mvp = { { 0 } };
+    mvp.m[0] = FIX16_ONE;
+    mvp.m[5] = FIX16_ONE;
+    mvp.m[10] = FIX16_ONE;
+    mvp.m[11] = FIX16_ONE;
+    int sx = -1, sy = -1;
+    fvec3_t v = { 0, 0, FIX16_ONE };
+
+    check(fproject_to_screen(mvp, v, WIDTH, HEIGHT, &sx, &sy) && sx == WIDTH / 2 && sy == HEIGHT / 2,
+          "centre projects to the canvas centre");
+    v.z = 0;
+    check(!fproject_to_screen(mvp, v, WIDTH, HEIGHT, &sx, &sy), "w = 0 rejected");
+    v.z = FIX16_NEAR_W - 1;
+    check(!fproject_to_screen(mvp, v, WIDTH, HEIGHT, &sx, &sy), "w below the near epsilon rejected");
+    v.x = 8 * FIX16_ONE;
+    v.z = FIX16_NEAR_W;
+    check(fproject_to_screen(mvp, v, WIDTH, HEIGHT, &sx, &sy) && sx > WIDTH, "w at the near epsilon projects");
+    v.x = 30000 * FIX16_ONE;
+    check(!fproject_to_screen(mvp, v, 30000, HEIGHT, &sx, &sy), "projections beyond the screen limit rejected");
+}
+
+// Unclipped reference walk: every step, bounds and mask checked per pixel
+static int in_mask(const viewport_mask_t* mask, int x, int y) {
+    if (!mask) return 1;
+    for (int i = mask->row_start[y]; i < mask->row_start[y + 1]; i++) {
+        if (x >= mask->spans[i].xmin && x <= mask->spans[i].xmax) return 1;
+    }
+    return 0;
+}
+
+static void reference_line(canvas8_t* canvas, const viewport_mask_t* mask, int x0, int y0, int x1, int y1) {
+    int dx = abs(x1 - x0), dy = -abs(y1 - y0);
+    int step_x = x0 < x1 ? 1 : -1, step_y = y0 < y1 ? 1 : -1;
+    int err = dx + dy;
+    while (1) {
+        if (x0 >= 0 && y0 >= 0 && x0 < canvas->width && y0 < canvas->height && in_mask(mask, x0, y0)) {
+            canvas->pixels[y0 * canvas->width + x0]++;
+        }
+        if (x0 == x1 && y0 == y1) break;
+        int e2 = 2 * err;
+        if (e2 >= dy) { err += dy; x0 += step_x; }
+        if (e2 <= dx) { err += dx; y0 += step_y; }
+    }
+}
+
+// Lines clipped before the walk light exactly the pixels of the full walk
+static void test_clipping(void) {
+    int width = 61, height = 47;
+    const viewport_mask_t* masks[2] = { NULL, NULL };
+    canvas8_t* clipped = canvas8_create(width, height);
+    canvas8_t* reference = canvas8_create(width, height);
+    masks[1] = canvas8_viewport_mask(clipped);
+
+    for (int m = 0; m < 2; m++) {
+        canvas8_clear(clipped);
+        canvas8_clear(reference);
+        for (int i = 0; i < 2000; i++) {
+            int range = (i % 3 == 0) ? 20000 : 150;
+            int x0 = width / 2 + random_coord(range), y0 = height / 2 + random_coord(range);
+            int x1 = width / 2 + random_coord(range), y1 = height / 2 + random_coord(range);
+            if (i % 7 == 0) y1 = y0 + random_coord(2);
+            if (i % 11 == 0) x1 = x0 + random_coord(2);
+            canvas8_draw_line_masked(clipped, masks[m], x0, y0, x1, y1, 1);
+            reference_line(reference, masks[m], x0, y0, x1, y1);
+        }
+        int mismatched = 0;
+        for (int k = 0; k < width * height; k++) mismatched += clipped->pixels[k] != reference->pixels[k];
+        check(mismatched == 0, m ? "masked clipped walk matches the full walk" : "clipped walk matches the full walk");
+    }
+
+    // A line far longer than the canvas still lights exactly one row
+    canvas8_clear(clipped);
+    canvas8_draw_line(clipped, -FIX16_SCREEN_LIMIT, 10, FIX16_SCREEN_LIMIT, 10, 255);
+    int lit = 0;
+    for (int k = 0; k < width * height; k++) lit += clipped->pixels[k] != 0;
+    check(lit == width && clipped->pixels[10 * width] == 255, "screen-limit line fills its row");
+    canvas8_draw_line(clipped, -FIX16_SCREEN_LIMIT - 1, 20, 10, 20, 255);
+    check(clipped->pixels[20 * width] == 0, "endpoints beyond the screen limit rejected");
+
+    canvas8_destroy(reference);
+    canvas8_destroy(clipped);
+}
+
+int main() {
+    random_seed(99u);
+    test_conversions();
+    test_error_bound();
+    test_near_and_far();
+    test_clipping();
+
+    return test_report("test_fixed3d");
+}
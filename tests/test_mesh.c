@@ -0,0 +1,136 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mesh.h"
+#include "test_util.h"
+
+#define OBJ_FILE  "test_mesh.obj"
+#define MESH_FILE "test_mesh.t3m"
+
+static void write_text(const char* filename, const char* text) {
+    FILE* f = fopen(filename, "wb");
+    if (f) {
+        fputs(text, f);
+        fclose(f);
+    }
+}
+
+// Overwrites one uint32_t of a mesh file at a byte offset
+static void patch_u32(const char* filename, long offset, uint32_t value) {
+    FILE* f = fopen(filename, "r+b");
+    if (f) {
+        fseek(f, offset, SEEK_SET);
+        fwrite(&value, sizeof(value), 1, f);
+        fclose(f);
+    }
+}
+
+// Unit cube as quads. Every edge is shared by two faces, faces mix plain,
+// v/vt, v//vn and v/vt/vn tokens, and one face uses relative indices.
+static const char* cube_obj =
+    "# cube\n"
+    "v -0.5 -0.5 -0.5\n"
+    "v  0.5 -0.5 -0.5\n"
+    "v  0.5  0.5 -0.5\n"
+    "v -0.5  0.5 -0.5\n"
+    "v -0.5 -0.5  0.5\n"
+    "v  0.5 -0.5  0.5\n"
+    "v  0.5  0.5  0.5 1.0\n"
+    "v -0.5  0.5  0.5\n"
+    "vt 0 0\n"
+    "vn 0 0 1\n"
+    "f 1/1/1 2/1/1 3/1/1 4/1/1\n"
+    "f 5//1 8//1 7//1 6//1\n"
+    "f -8 -7 -3 -4   # bottom: 1 2 6 5\n"
+    "f 2/1 3/1 7/1 6/1\n"
+    "f 3 4 8 7\r\n"
+    "f 4 1 5 8\n"
+    "l 1 7 1\n";
+
+static void test_convert_cube(void) {
+    write_text(OBJ_FILE, cube_obj);
+    check(mesh_convert_obj(OBJ_FILE, MESH_FILE) == 0, "cube converts");
+
+    mesh_t* mesh = mesh_open(MESH_FILE);
+    check(mesh != NULL, "converted cube opens");
+    if (!mesh) return;
+    check(mesh_validate(mesh) == 0, "converted indices validate");
+
+    check(mesh->vertex_count == 8, "8 vertices");
+    check(mesh->triangle_count == 12, "6 quads fan into 12 triangles");
+    check(mesh->edge_count == 13, "12 shared cube edges plus 1 polyline edge, deduplicated");
+    check(mesh->positions[6 * 3 + 0] == 0.5f && mesh->positions[6 * 3 + 2] == 0.5f, "optional w ignored");
+
+    int sorted = 1;
+    for (int i = 0; i < mesh->edge_count; i++) {
+        if (mesh->edges[i][0] >= mesh->edges[i][1]) sorted = 0;
+        if (i > 0 && (mesh->edges[i - 1][0] > mesh->edges[i][0] ||
+                      (mesh->edges[i - 1][0] == mesh->edges[i][0] && mesh->edges[i - 1][1] >= mesh->edges[i][1]))) {
+            sorted = 0;
+        }
+    }
+    check(sorted, "edges are (a < b), sorted and unique");
+
+    // Third face "-8 -7 -3 -4" is vertices 0 1 5 4
+    const uint32_t* t = mesh->triangles[4];
+    check(t[0] == 0 && t[1] == 1 && t[2] == 5, "relative indices resolve (first fan triangle)");
+    t = mesh->triangles[5];
+    check(t[0] == 0 && t[1] == 5 && t[2] == 4, "relative indices resolve (second fan triangle)");
+    mesh_close(mesh);
+}
+
+static void test_malformed_obj(void) {
+    write_text(OBJ_FILE, "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 4\n");
+    check(mesh_convert_obj(OBJ_FILE, MESH_FILE) != 0, "index past the last vertex rejected");
+
+    write_text(OBJ_FILE, "v 0 0 0\nv 1 0 0\nf 1 -3 2\n");
+    check(mesh_convert_obj(OBJ_FILE, MESH_FILE) != 0, "relative index before the first vertex rejected");
+
+    write_text(OBJ_FILE, "v 0 0 0\nv 1 0 0\nl 0 1\n");
+    check(mesh_convert_obj(OBJ_FILE, MESH_FILE) != 0, "index 0 rejected");
+
+    check(mesh_convert_obj("no_such_file.obj", MESH_FILE) != 0, "missing OBJ rejected");
+}
+
+static void test_malformed_mesh(void) {
+    long edge_offset = (long)(sizeof(mesh_header_t) + 8 * 3 * sizeof(float) + 12 * 3 * sizeof(uint32_t));
+    long triangle_offset = (long)(sizeof(mesh_header_t) + 8 * 3 * sizeof(float));
+
+    write_text(OBJ_FILE, cube_obj);
+    mesh_convert_obj(OBJ_FILE, MESH_FILE);
+    patch_u32(MESH_FILE, edge_offset + 4, 1000000000u);
+    mesh_t* mesh = mesh_open(MESH_FILE);
+    check(mesh != NULL && mesh_validate(mesh) != 0, "out-of-range edge index rejected by validation");
+    mesh_close(mesh);
+
+    mesh_convert_obj(OBJ_FILE, MESH_FILE);
+    patch_u32(MESH_FILE, triangle_offset + 8, 8u);
+    mesh = mesh_open(MESH_FILE);
+    check(mesh != NULL && mesh_validate(mesh) != 0, "out-of-range triangle index rejected by validation");
+    mesh_close(mesh);
+
+    mesh_convert_obj(OBJ_FILE, MESH_FILE);
+    patch_u32(MESH_FILE, (long)offsetof(mesh_header_t, edge_count), 0x80000000u);
+    check(mesh_open(MESH_FILE) == NULL, "count above INT_MAX rejected");
+
+    mesh_convert_obj(OBJ_FILE, MESH_FILE);
+    patch_u32(MESH_FILE, (long)offsetof(mesh_header_t, edge_count), 14u);
+    check(mesh_open(MESH_FILE) == NULL, "counts larger than the file rejected");
+
+    mesh_convert_obj(OBJ_FILE, MESH_FILE);
+    patch_u32(MESH_FILE, 0, 0u);
+    check(mesh_open(MESH_FILE) == NULL, "bad magic rejected");
+
+    write_text(MESH_FILE, "T3DM");
+    check(mesh_open(MESH_FILE) == NULL, "truncated header rejected");
+}
+
+int main() {
+    test_convert_cube();
+    test_malformed_obj();
+    test_malformed_mesh();
+    remove(OBJ_FILE);
+    remove(MESH_FILE);
+
+    return test_report("test_mesh");
+}
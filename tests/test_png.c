@@ -0,0 +1,324 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "canvas.h"
+#include "test_util.h"
+
+#define PNG_FILE "test_png.png"
+
+// Independent decoder: chunk parsing, CRC and Adler checks, a small inflater
+// for the block types the encoder emits (stored and fixed Huffman) and unfiltering.
+
+static uint32_t get_u32_be(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static uint32_t crc32(const uint8_t* data, size_t len) {
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (int k = 0; k < 8; k++) crc = (crc & 1) ? 0xEDB88320u ^ (crc >> 1) : crc >> 1;
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+static uint32_t adler32(const uint8_t* data, size_t len) {
+    uint32_t a = 1, b = 0;
+    for (size_t i = 0; i < len; i++) {
+        a = (a + data[i]) % 65521;
+        b = (b + a) % 65521;
+    }
+    return (b << 16) | a;
+}
+
+typedef struct {
+    const uint8_t* in;
+    size_t in_len, in_pos;
+    uint32_t bit_buf;
+    int bit_count;
+    uint8_t* out;
+    size_t out_len, out_cap;
+    int error;
+} inflate_state_t;
+
+static int get_bits(inflate_state_t* s, int count) {
+    while (s->bit_count < count) {
+        if (s->in_pos >= s->in_len) {
+            s->error = 1;
+            return 0;
+        }
+        s->bit_buf |= (uint32_t)s->in[s->in_pos++] << s->bit_count;
+        s->bit_count += 8;
+    }
+    int v = (int)(s->bit_buf & ((1u << count) - 1));
+    s->bit_buf >>= count;
+    s->bit_count -= count;
+    return v;
+}
+
+static void put_out(inflate_state_t* s, uint8_t v) {
+    if (s->out_len >= s->out_cap) {
+        s->error = 1;
+        return;
+    }
+    s->out[s->out_len++] = v;
+}
+
+// Canonical Huffman table: symbols ordered by code length, then value
+typedef struct {
+    short count[16];
+    short symbol[288];
+} huffman_t;
+
+static void build_huffman(huffman_t* h, const uint8_t* lengths, int n) {
+    short offsets[16];
+    memset(h->count, 0, sizeof(h->count));
+    for (int i = 0; i < n; i++) h->count[lengths[i]]++;
+    h->count[0] = 0;
+    offsets[1] = 0;
+    for (int len = 1; len < 15; len++) offsets[len + 1] = offsets[len] + h->count[len];
+    for (int i = 0; i < n; i++) {
+        if (lengths[i]) h->symbol[offsets[lengths[i]]++] = (short)i;
+    }
+}
+
+// Codes are read MSB-first one bit at a time
+static int decode_symbol(inflate_state_t* s, const huffman_t* h) {
+    int code = 0, first = 0, index = 0;
+    for (int len = 1; len < 16; len++) {
+        code |= get_bits(s, 1);
+        int count = h->count[len];
+        if (code - first < count) return h->symbol[index + code - first];
+        index += count;
+        first = (first + count) << 1;
+        code <<= 1;
+    }
+    s->error = 1;
+    return -1;
+}
+
+static void inflate_fixed(inflate_state_t* s) {
+    static const short length_base[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                           35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+    static const short length_extra[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                            3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+    static const short dist_base[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385,
+                                         513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+    static const short dist_extra[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                          7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+    uint8_t lengths[288];
+    huffman_t literals, distances;
+    for (int i = 0; i < 288; i++) lengths[i] = i < 144 ? 8 : (i < 256 ? 9 : (i < 280 ? 7 : 8));
+    build_huffman(&literals, lengths, 288);
+    for (int i = 0; i < 30; i++) lengths[i] = 5;
+    build_huffman(&distances, lengths, 30);
+
+    while (!s->error) {
+        int sym = decode_symbol(s, &literals);
+        if (sym < 0 || sym == 256) return;
+        if (sym < 256) {
+            put_out(s, (uint8_t)sym);
+            continue;
+        }
+        sym -= 257;
+        if (sym >= 29) {
+            s->error = 1;
+            return;
+        }
+        int length = length_base[sym] + get_bits(s, length_extra[sym]);
+        int dsym = decode_symbol(s, &distances);
+        if (dsym < 0 || dsym >= 30) {
+            s->error = 1;
+            return;
+        }
+        size_t distance = (size_t)dist_base[dsym] + get_bits(s, dist_extra[dsym]);
+        if (distance > s->out_len) {
+            s->error = 1;
+            return;
+        }
+        while (length--) put_out(s, s->out[s->out_len - distance]);
+    }
+}
+
+// Returns the number of bytes inflated, or -1; *types collects the block types seen
+static long inflate_zlib(const uint8_t* in, size_t len, uint8_t* out, size_t cap, int* types) {
+    if (len < 6 || (in[0] & 0x0F) != 8 || ((in[0] << 8) | in[1]) % 31 != 0 || (in[1] & 0x20)) return -1;
+    inflate_state_t s = { in + 2, len - 6, 0, 0, 0, out, 0, cap, 0 };
+    *types = 0;
+
+    int final;
+    do {
+        final = get_bits(&s, 1);
+        int type = get_bits(&s, 2);
+        *types |= 1 << type;
+        if (type == 0) {
+            s.bit_buf = 0;
+            s.bit_count = 0;
+            if (s.in_pos + 4 > s.in_len) return -1;
+            const uint8_t* p = s.in + s.in_pos;
+            unsigned stored = p[0] | (p[1] << 8);
+            if ((stored ^ (unsigned)(p[2] | (p[3] << 8))) != 0xFFFF) return -1;
+            s.in_pos += 4;
+            if (s.in_pos + stored > s.in_len) return -1;
+            for (unsigned i = 0; i < stored; i++) put_out(&s, s.in[s.in_pos + i]);
+            s.in_pos += stored;
+        } else if (type == 1) {
+            inflate_fixed(&s);
+        } else {
+            return -1;
+        }
+        if (s.error) return -1;
+    } while (!final);
+
+    // Whole bytes consumed by the stream, then the big-endian Adler-32 trailer
+    if (s.in_pos != s.in_len) return -1;
+    if (get_u32_be(in + len - 4) != adler32(out, s.out_len)) return -1;
+    return (long)s.out_len;
+}
+
+static int paeth(int a, int b, int c) {
+    int p = a + b - c;
+    int pa = abs(p - a), pb = abs(p - b), pc = abs(p - c);
+    if (pa <= pb && pa <= pc) return a;
+    if (pb <= pc) return b;
+    return c;
+}
+
+// Decodes an 8-bit grayscale PNG into a malloc'd width * height buffer, or NULL
+static uint8_t* decode_png(const char* filename, int* width, int* height, int* types) {
+    FILE* f = fopen(filename, "rb");
+    if (!f) return NULL;
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t* file = malloc(size);
+    if (!file || fread(file, 1, size, f) != (size_t)size) {
+        fclose(f);
+        free(file);
+        return NULL;
+    }
+    fclose(f);
+
+    static const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    uint8_t* idat = malloc(size);
+    uint8_t* pixels = NULL;
+    size_t idat_len = 0;
+    int w = 0, h = 0, seen_end = 0;
+    long pos = 8;
+    if (size < 8 || memcmp(file, signature, 8) != 0) goto done;
+
+    while (pos + 12 <= size && !seen_end) {
+        uint32_t len = get_u32_be(file + pos);
+        const uint8_t* type = file + pos + 4;
+        if (pos + 12 + (long)len > size) goto done;
+        if (get_u32_be(file + pos + 8 + len) != crc32(type, len + 4)) goto done;
+        const uint8_t* data = file + pos + 8;
+        if (memcmp(type, "IHDR", 4) == 0) {
+            if (len != 13 || data[8] != 8 || data[9] != 0 || data[10] || data[11] || data[12]) goto done;
+            w = (int)get_u32_be(data);
+            h = (int)get_u32_be(data + 4);
+        } else if (memcmp(type, "IDAT", 4) == 0) {
+            memcpy(idat + idat_len, data, len);
+            idat_len += len;
+        } else if (memcmp(type, "IEND", 4) == 0) {
+            seen_end = 1;
+        }
+        pos += 12 + len;
+    }
+    if (!seen_end || pos != size || w <= 0 || h <= 0) goto done;
+
+    size_t stride = (size_t)w + 1;
+    uint8_t* raw = malloc(stride * h);
+    pixels = malloc((size_t)w * h);
+    if (inflate_zlib(idat, idat_len, raw, stride * h, types) != (long)(stride * h)) {
+        free(pixels);
+        pixels = NULL;
+    }
+    for (int y = 0; pixels && y < h; y++) {
+        const uint8_t* in = raw + y * stride;
+        uint8_t* row = pixels + (size_t)y * w;
+        const uint8_t* above = y > 0 ? row - w : NULL;
+        if (in[0] > 4) {
+            free(pixels);
+            pixels = NULL;
+            break;
+        }
+        for (int x = 0; x < w; x++) {
+            int a = x > 0 ? row[x - 1] : 0;
+            int b = above ? above[x] : 0;
+            int c = (x > 0 && above) ? above[x - 1] : 0;
+            int pred = in[0] == 1 ? a : in[0] == 2 ? b : in[0] == 3 ? (a + b) / 2 : in[0] == 4 ? paeth(a, b, c) : 0;
+            row[x] = (uint8_t)(in[1 + x] + pred);
+        }
+    }
+    free(raw);
+    *width = w;
+    *height = h;
+
+done:
+    free(idat);
+    free(file);
+    return pixels;
+}
+
+// Small deterministic LCG so the images are the same on every run
+// Mostly black like a wireframe frame, with lines, a gradient, noise and out-of-range values
+static void fill_canvas(canvas_t* canvas) {
+    for (int y = 0; y < canvas->height; y++) {
+        for (int x = 0; x < canvas->width; x++) {
+            float v = 0.0f;
+            if (y % 7 == 3 || x == y) v = 1.0f;
+            else if (x < canvas->width / 4) v = (float)x / canvas->width;
+            else if (y > canvas->height * 3 / 4) v = random_unit();
+            if (x == 1 && y == 0) v = 3.5f;     // Clamps to 255
+            if (x == 2 && y == 0) v = -0.5f;    // Clamps to 0
+            canvas->pixels[y][x] = v;
+        }
+    }
+}
+
+static void test_round_trip(int width, int height) {
+    canvas_t* canvas = canvas_create(width, height);
+    fill_canvas(canvas);
+
+    for (int level = 0; level <= 9; level++) {
+        char what[96];
+        int w = 0, h = 0, types = 0;
+        remove(PNG_FILE);
+        canvas_save_png(canvas, PNG_FILE, level);
+        uint8_t* pixels = decode_png(PNG_FILE, &w, &h, &types);
+
+        snprintf(what, sizeof(what), "%dx%d level %d decodes", width, height, level);
+        check(pixels != NULL && w == width && h == height, what);
+        if (!pixels) continue;
+
+        int mismatched = 0;
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                int expected = (int)(canvas->pixels[y][x] * 255);
+                if (expected > 255) expected = 255;
+                if (expected < 0) expected = 0;
+                if (pixels[(size_t)y * width + x] != expected) mismatched++;
+            }
+        }
+        snprintf(what, sizeof(what), "%dx%d level %d pixels match", width, height, level);
+        check(mismatched == 0, what);
+        snprintf(what, sizeof(what), "%dx%d level %d block type", width, height, level);
+        check(types == (level == 0 ? 1 << 0 : 1 << 1), what);
+        free(pixels);
+    }
+    canvas_destroy(canvas);
+}
+
+int main() {
+    random_seed(2024u);
+    test_round_trip(1, 1);
+    test_round_trip(3, 2);
+    test_round_trip(17, 5);
+    test_round_trip(255, 3);
+    test_round_trip(301, 257);     // Over 65535 bytes: several stored blocks at level 0
+    remove(PNG_FILE);
+
+    return test_report("test_png");
+}
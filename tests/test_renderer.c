@@ -0,0 +1,116 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "renderer.h"
+#include "canvas.h"
+#include "soccerball.h"
+#include "test_util.h"
+
+#define VIEW_COUNT 5
+
+static int canvases_equal(const canvas_t* a, const canvas_t* b) {
+    if (a->width != b->width || a->height != b->height) return 0;
+    for (int y = 0; y < a->height; y++) {
+        if (memcmp(a->pixels[y], b->pixels[y], (size_t)a->width * sizeof(float)) != 0) return 0;
+    }
+    return 1;
+}
+
+// Every view of a multi-view render matches a render_wireframe of that view,
+// whichever thread drew it. Canvas sizes differ so views cannot share a mask.
+static void test_multi_matches_single(void) {
+    vec3_t* vertices = NULL;
+    int vertex_count = 0;
+    int (*edges)[2] = NULL;
+    int edge_count = 0;
+    generate_soccer_ball(&vertices, &vertex_count, &edges, &edge_count);
+
+    static const int sizes[VIEW_COUNT][2] = { { 200, 200 }, { 161, 97 }, { 64, 64 }, { 255, 130 }, { 99, 181 } };
+    mat4_t model = mat4_rotate_xyz(0.4f, 1.1f, 0.2f);
+    render_view_t views[VIEW_COUNT];
+    canvas_t* expected[VIEW_COUNT];
+    for (int v = 0; v < VIEW_COUNT; v++) {
+        float aspect_ratio = (float)sizes[v][0] / sizes[v][1];
+        views[v].canvas = canvas_create(sizes[v][0], sizes[v][1]);
+        views[v].view = mat4_multiply(mat4_translate(0.3f * v - 0.6f, 0.1f * v, -4.0f - 0.5f * v),
+                                      mat4_rotate_xyz(0.0f, 0.3f * v, 0.0f));
+        views[v].projection = mat4_frustum_asymmetric(-aspect_ratio, aspect_ratio, -1.0f, 1.0f, 1.0f, 10.0f);
+        expected[v] = canvas_create(sizes[v][0], sizes[v][1]);
+        render_wireframe(expected[v], vertices, vertex_count, edges, edge_count,
+                         model, views[v].view, views[v].projection);
+    }
+
+    static const int thread_counts[] = { 1, 2, 3, VIEW_COUNT + 3 };
+    for (int k = 0; k < (int)(sizeof(thread_counts) / sizeof(thread_counts[0])); k++) {
+        for (int v = 0; v < VIEW_COUNT; v++) canvas_clear(views[v].canvas);
+        int result = render_wireframe_multi(vertices, vertex_count, edges, edge_count,
+                                            model, views, VIEW_COUNT, thread_counts[k]);
+        check(result == 0, "multi-view render succeeds");
+
+        int matching = 0;
+        for (int v = 0; v < VIEW_COUNT; v++) matching += canvases_equal(views[v].canvas, expected[v]);
+        char what[64];
+        snprintf(what, sizeof(what), "all views match render_wireframe with %d thread(s)", thread_counts[k]);
+        check(matching == VIEW_COUNT, what);
+    }
+
+    int lit = 0;
+    for (int x = 0; x < expected[0]->width; x++) lit += expected[0]->pixels[100][x] != 0.0f;
+    check(lit > 0, "reference view is not empty");
+
+    check(render_wireframe_multi(vertices, vertex_count, edges, edge_count, model, views, 0, 4) == 0,
+          "no views is a no-op");
+
+    for (int v = 0; v < VIEW_COUNT; v++) {
+        canvas_destroy(views[v].canvas);
+        canvas_destroy(expected[v]);
+    }
+    free(edges);
+    free(vertices);
+}
+
+// A mask of another size is reported and nothing is drawn; the right size draws
+static void test_masked_size_mismatch(void) {
+    vec3_t* vertices = NULL;
+    int vertex_count = 0;
+    int (*edges)[2] = NULL;
+    int edge_count = 0;
+    generate_soccer_ball(&vertices, &vertex_count, &edges, &edge_count);
+
+    canvas_t* canvas = canvas_create(120, 90);
+    canvas_clear(canvas);
+    mat4_t model = mat4_rotate_xyz(0.2f, 0.5f, 0.0f);
+    mat4_t view = mat4_translate(0.0f, 0.0f, -4.0f);
+    mat4_t projection = mat4_frustum_asymmetric(-1.33f, 1.33f, -1.0f, 1.0f, 1.0f, 10.0f);
+    static const int sizes[3][2] = { { 119, 90 }, { 120, 91 }, { 60, 45 } };
+
+    int lit = 0;
+    for (int k = 0; k < 3; k++) {
+        viewport_mask_t* mask = viewport_mask_circle(sizes[k][0], sizes[k][1]);
+        render_wireframe_masked(canvas, mask, vertices, vertex_count, edges, edge_count, model, view, projection);
+        viewport_mask_destroy(mask);
+    }
+    for (int y = 0; y < canvas->height; y++) {
+        for (int x = 0; x < canvas->width; x++) lit += canvas->pixels[y][x] != 0.0f;
+    }
+    check(lit == 0, "masks of another size leave the canvas untouched");
+
+    viewport_mask_t* mask = viewport_mask_circle(canvas->width, canvas->height);
+    render_wireframe_masked(canvas, mask, vertices, vertex_count, edges, edge_count, model, view, projection);
+    for (int y = 0; y < canvas->height; y++) {
+        for (int x = 0; x < canvas->width; x++) lit += canvas->pixels[y][x] != 0.0f;
+    }
+    check(lit > 0, "a mask of the canvas size draws");
+
+    viewport_mask_destroy(mask);
+    canvas_destroy(canvas);
+    free(edges);
+    free(vertices);
+}
+
+int main() {
+    test_multi_matches_single();
+    test_masked_size_mismatch();
+
+    return test_report("test_renderer");
+}
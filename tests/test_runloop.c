@@ -0,0 +1,209 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <math.h>
+#include <time.h>
+#include "runloop.h"
+#include "test_util.h"
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Simulated clock: renders advance it by their work time and sleeps jump to
+// the deadline plus a repeating overshoot, so pacing is checked exactly
+typedef struct {
+    double time;
+    const double *overshoot;    // Extra time each sleep takes, cycled
+    int overshoot_count;
+    int sleeps;
+    double frame_starts[256];
+    int frame_count;
+} fake_clock_t;
+
+static double fake_now(void *clock_user) {
+    fake_clock_t *clock = clock_user;
+    return clock->time;
+}
+
+static void fake_sleep_until(void *clock_user, double deadline) {
+    fake_clock_t *clock = clock_user;
+    double extra = clock->overshoot_count ? clock->overshoot[clock->sleeps % clock->overshoot_count] : 0.0;
+    clock->sleeps++;
+    if (deadline > clock->time) clock->time = deadline + extra;
+}
+
+typedef struct {
+    int updates;
+    int renders;
+    double simulated;
+    double last_alpha;
+    int last_quality;
+    double busy;                // Seconds each render takes
+    int stall_frame;            // Render that takes stall_time instead (-1 for none)
+    double stall_time;
+    fake_clock_t *clock;        // Advanced instead of spinning when set
+} counters_t;
+
+static void update(void *user, double dt) {
+    counters_t *c = user;
+    c->updates++;
+    c->simulated += dt;
+}
+
+static void render(void *user, double alpha, int quality) {
+    counters_t *c = user;
+    double work = c->renders == c->stall_frame ? c->stall_time : c->busy;
+    c->renders++;
+    c->last_alpha = alpha;
+    c->last_quality = quality;
+    if (c->clock) {
+        fake_clock_t *clock = c->clock;
+        if (clock->frame_count < 256) clock->frame_starts[clock->frame_count++] = clock->time;
+        clock->time += work;
+    } else if (work > 0.0) {
+        double until = now() + work;
+        while (now() < until) {
+        }
+    }
+}
+
+static void test_fixed_step(void) {
+    counters_t c = { 0 };
+    runloop_config_t config = runloop_default_config();
+    config.sim_step = 0.01;
+    config.max_steps_per_frame = 3;
+    runloop_t *loop = runloop_create(config, update, render, &c);
+
+    runloop_frame(loop, 0.025);
+    check(c.updates == 2 && c.renders == 1, "two whole steps per 25 ms");
+    check(fabs(c.last_alpha - 0.5) < 1e-9, "leftover half step passed as alpha");
+
+    runloop_frame(loop, 0.005);
+    check(c.updates == 3 && fabs(c.last_alpha) < 1e-9, "carried time completes a step");
+
+    runloop_frame(loop, 0.1);
+    check(c.updates == 6, "catch-up limited to max_steps_per_frame");
+    check(loop->dropped_steps == 7 && loop->accumulator < config.sim_step, "older backlog dropped");
+    check(fabs(loop->sim_time - c.simulated) < 1e-12, "sim_time tracks the steps taken");
+
+    config.sim_step = 0.0;
+    check(runloop_create(config, update, render, &c) == NULL, "zero step rejected");
+    runloop_destroy(loop);
+}
+
+static void test_quality(void) {
+    runloop_config_t config = runloop_default_config();
+    config.frame_budget = 0.010;
+    config.max_quality_level = 2;
+    config.recover_frames = 5;
+    runloop_t *loop = runloop_create(config, NULL, NULL, NULL);
+
+    for (int i = 0; i < 3; i++) runloop_record_frame(loop, 0.020);
+    check(loop->quality == 2 && loop->overrun_count == 3, "overruns degrade up to the limit");
+
+    for (int i = 0; i < 4; i++) runloop_record_frame(loop, 0.005);
+    check(loop->quality == 2, "no recovery before recover_frames");
+    runloop_record_frame(loop, 0.009);     // Under budget but not comfortably: breaks the streak
+    for (int i = 0; i < 4; i++) runloop_record_frame(loop, 0.005);
+    check(loop->quality == 2, "streak restarts after a borderline frame");
+    runloop_record_frame(loop, 0.005);
+    check(loop->quality == 1, "sustained fast frames recover one level");
+
+    check(fabs(runloop_frame_percentile(loop, 50.0) - 0.006) < 1e-9, "median work in the 5-6 ms bucket");
+    check(fabs(runloop_frame_percentile(loop, 100.0) - 0.021) < 1e-9, "worst work in the 20-21 ms bucket");
+    runloop_record_frame(loop, 1.0);
+    check(runloop_frame_percentile(loop, 100.0) == 1.0, "overflow bucket reports the worst frame");
+    runloop_destroy(loop);
+}
+
+// Paced frames must start on the budget's schedule: sleep overshoot does not
+// accumulate, and the interval histogram sees the real spacing
+static void test_pacing(void) {
+    static const double overshoot[3] = { 0.0, 0.0003, 0.0012 };
+    fake_clock_t clock = { 100.0, overshoot, 3, 0, { 0 }, 0 };
+    counters_t c = { 0 };
+    c.busy = 0.0025;
+    c.stall_frame = -1;
+    c.clock = &clock;
+    runloop_config_t config = runloop_default_config();
+    config.sim_step = 0.005;
+    config.frame_budget = 0.005;
+    runloop_t *loop = runloop_create(config, update, render, &c);
+    runloop_set_clock(loop, fake_now, fake_sleep_until, &clock);
+
+    int frames = 200;
+    runloop_run(loop, frames);
+
+    check(c.renders == frames && loop->frame_count == (unsigned long)frames, "ran max_frames frames");
+    check(loop->interval_count == (unsigned long)(frames - 1), "one interval between each pair of frames");
+    check(clock.sleeps == frames, "one sleep per frame");
+
+    // Frame k starts at its deadline plus at most one overshoot, never later
+    int late = 0;
+    for (int k = 0; k < frames; k++) {
+        double offset = clock.frame_starts[k] - (100.0 + k * config.frame_budget);
+        if (offset < -1e-9 || offset > 0.0012 + 1e-9) late++;
+    }
+    check(late == 0, "every frame starts within one overshoot of its deadline");
+    check(fabs(clock.time - (100.0 + frames * config.frame_budget)) <= 0.0012 + 1e-9, "no accumulated drift");
+
+    check(runloop_interval_percentile(loop, 50.0) == 0.006, "median interval in the 5-6 ms bucket");
+    check(loop->worst_interval < 0.0063, "intervals vary only by the overshoot");
+    check(runloop_frame_percentile(loop, 100.0) == 0.003, "work histogram excludes the sleep");
+    check(loop->running == 0, "loop stopped");
+    runloop_destroy(loop);
+}
+
+// A stall of several frames restarts the schedule instead of bursting to catch up
+static void test_stall(void) {
+    fake_clock_t clock = { 0.0, NULL, 0, 0, { 0 }, 0 };
+    counters_t c = { 0 };
+    c.busy = 0.001;
+    c.stall_frame = 10;
+    c.stall_time = 0.030;
+    c.clock = &clock;
+    runloop_config_t config = runloop_default_config();
+    config.frame_budget = 0.005;
+    runloop_t *loop = runloop_create(config, update, render, &c);
+    runloop_set_clock(loop, fake_now, fake_sleep_until, &clock);
+
+    runloop_run(loop, 30);
+
+    int bursts = 0;
+    for (int k = 12; k < 30; k++) {
+        if (clock.frame_starts[k] - clock.frame_starts[k - 1] < config.frame_budget - 1e-9) bursts++;
+    }
+    check(bursts == 0, "frames after a stall stay a budget apart");
+    check(fabs(clock.frame_starts[11] - (clock.frame_starts[10] + 0.030)) < 1e-9, "frame after the stall starts at once");
+    check(loop->overrun_count == 1 && loop->quality == 1, "stall counted as one overrun");
+    check(loop->worst_interval > 0.030 - 1e-9, "interval histogram records the stall");
+    runloop_destroy(loop);
+}
+
+// Informational only: the real clock depends on the machine's load
+static void report_real_clock(void) {
+    counters_t c = { 0 };
+    c.busy = 0.001;
+    c.stall_frame = -1;
+    runloop_config_t config = runloop_default_config();
+    config.frame_budget = 0.005;
+    runloop_t *loop = runloop_create(config, update, render, &c);
+
+    double start = now();
+    runloop_run(loop, 40);
+    printf("test_runloop: real clock, 40 frames at 5 ms took %.1f ms, median interval <= %.0f ms\n",
+           (now() - start) * 1000.0, runloop_interval_percentile(loop, 50.0) * 1000.0);
+    runloop_destroy(loop);
+}
+
+int main() {
+    test_fixed_step();
+    test_quality();
+    test_pacing();
+    test_stall();
+    report_real_clock();
+
+    return test_report("test_runloop");
+}
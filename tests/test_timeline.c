@@ -0,0 +1,149 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "timeline.h"
+#include "test_util.h"
+
+#define CURVE_COUNT 20000
+#define END_TIME 1000.0f
+
+static int near(vec3_t a, vec3_t b) {
+    return fabsf(a.x - b.x) < 1e-4f && fabsf(a.y - b.y) < 1e-4f && fabsf(a.z - b.z) < 1e-4f;
+}
+
+static vec3_t point(float x, float y, float z) {
+    vec3_t v = { x, y, z, 0, 0, 0 };
+    return v;
+}
+
+// Small deterministic LCG so the schedule is the same on every run
+// The active set after every advance must equal the brute-force set {start <= t < end}
+static void test_sparse_active_set(void) {
+    animation_timeline_t* timeline = create_animation_timeline(16);
+    static float starts[CURVE_COUNT], ends[CURVE_COUNT];
+    static int seen[CURVE_COUNT];
+    bezier_curve_t curve = create_bezier_curve(point(0, 0, 0), point(1, 0, 0), point(1, 1, 0), point(0, 1, 0), 1.0f);
+
+    for (int i = 0; i < CURVE_COUNT; i++) {
+        starts[i] = random_unit() * END_TIME;
+        // Mostly short intervals, a few long ones and some zero-length ones
+        float length = (i % 50 == 0) ? random_unit() * 200.0f : (i % 7 == 0 ? 0.0f : random_unit() * 2.0f);
+        ends[i] = starts[i] + length;
+        check(timeline_add_curve(timeline, curve, starts[i], ends[i]) == i, "add_curve returns sequential ids");
+    }
+    check(timeline_add_curve(timeline, curve, 5.0f, 4.0f) == -1, "reversed interval rejected");
+
+    int max_active = 0;
+    float t = 0.0f;
+    while (t <= END_TIME + 250.0f) {
+        timeline_advance(timeline, t);
+
+        int count;
+        const int* active = timeline_active_curves(timeline, &count);
+        for (int i = 0; i < CURVE_COUNT; i++) seen[i] = 0;
+        for (int k = 0; k < count; k++) seen[active[k]]++;
+
+        int expected = 0, mismatched = 0;
+        for (int i = 0; i < CURVE_COUNT; i++) {
+            int want = starts[i] <= t && t < ends[i];
+            expected += want;
+            if (seen[i] != want) mismatched++;
+        }
+        if (mismatched || count != expected) {
+            printf("FAIL: active set at t=%.3f: %d active, %d expected, %d mismatched\n",
+                   t, count, expected, mismatched);
+            failures++;
+            break;
+        }
+        if (count > max_active) max_active = count;
+
+        // Uneven steps (some zero), sometimes landing exactly on a later interval boundary
+        int i = (int)(random_unit() * (CURVE_COUNT - 1));
+        float boundary = (i % 2) ? ends[i] : starts[i];
+        if (boundary > t && boundary < t + 3.0f) t = boundary;
+        else t += (random_unit() < 0.1f) ? 0.0f : random_unit() * 3.0f;
+    }
+    check(max_active > 0 && max_active < CURVE_COUNT / 10, "schedule is sparse but not empty");
+
+    int count;
+    timeline_active_curves(timeline, &count);
+    check(count == 0, "nothing active past the last interval");
+    free_animation_timeline(timeline);
+}
+
+static void test_boundaries(void) {
+    animation_timeline_t* timeline = create_animation_timeline(1);
+    bezier_curve_t curve = create_bezier_curve(point(0, 0, 0), point(1, 0, 0), point(1, 1, 0), point(0, 1, 0), 1.0f);
+    int a = timeline_add_curve(timeline, curve, 1.0f, 2.0f);
+    timeline_add_curve(timeline, curve, 2.0f, 2.0f);           // Zero length: never active
+    int c = timeline_add_curve(timeline, curve, 2.0f, 3.0f);
+    int count;
+    const int* active;
+
+    timeline_advance(timeline, 1.0f);
+    active = timeline_active_curves(timeline, &count);
+    check(count == 1 && active[0] == a, "active exactly at start_time");
+
+    timeline_update(timeline, 1.0f);
+    active = timeline_active_curves(timeline, &count);
+    check(count == 1 && active[0] == c, "end_time exclusive, next interval starts");
+
+    timeline_advance(timeline, 0.5f);   // Going back is ignored
+    check(timeline->current_time == 2.0f, "time never decreases");
+    free_animation_timeline(timeline);
+}
+
+static void test_sample(void) {
+    animation_timeline_t* timeline = create_animation_timeline(4);
+    vec3_t p0 = point(0, 0, 0), p1 = point(1, 0, 0), p2 = point(1, 1, 0), p3 = point(0, 1, 2);
+
+    bezier_curve_t looping = create_bezier_curve(p0, p1, p2, p3, 2.0f);
+    bezier_curve_t once = looping;
+    once.loop = 0;
+
+    int single = timeline_add_curve(timeline, looping, 10.0f, 12.0f);     // One whole cycle
+    int cycles = timeline_add_curve(timeline, looping, 10.0f, 16.0f);     // Three whole cycles
+    int partial = timeline_add_curve(timeline, looping, 10.0f, 13.0f);    // Ends mid-cycle
+    int clamped = timeline_add_curve(timeline, once, 10.0f, 15.0f);       // Non-looping, outlasts its curve
+
+    check(near(timeline_sample(timeline, single, 10.0f), p0), "start samples p0");
+    check(near(timeline_sample(timeline, single, 5.0f), p0), "before start holds p0");
+    check(near(timeline_sample(timeline, single, 11.0f), vec3_bezier(p0, p1, p2, p3, 0.5f)), "midpoint");
+    check(near(timeline_sample(timeline, single, 12.0f), p3), "looping curve ends at p3, not wrapped to p0");
+    check(near(timeline_sample(timeline, single, 50.0f), p3), "after end holds p3");
+    check(near(timeline_sample(timeline, cycles, 12.0f), p0), "loop wraps inside the interval");
+    check(near(timeline_sample(timeline, cycles, 15.0f), vec3_bezier(p0, p1, p2, p3, 0.5f)), "third cycle");
+    check(near(timeline_sample(timeline, cycles, 16.0f), p3), "multi-cycle interval ends at p3");
+    check(near(timeline_sample(timeline, partial, 20.0f), vec3_bezier(p0, p1, p2, p3, 0.5f)), "partial cycle holds its end");
+    check(near(timeline_sample(timeline, clamped, 14.0f), p3), "non-looping curve clamps at p3");
+
+    // Non-dyadic durations: end - start is not an exact multiple in floats
+    static const float durations[4] = { 0.1f, 0.3f, 0.7f, 1.1f };
+    for (int i = 0; i < 4; i++) {
+        bezier_curve_t c = create_bezier_curve(p0, p1, p2, p3, durations[i]);
+        float start = 0.2f;
+        for (int cycles_n = 1; cycles_n <= 3; cycles_n++) {
+            int id = timeline_add_curve(timeline, c, start, start + cycles_n * durations[i]);
+            check(near(timeline_sample(timeline, id, start + cycles_n * durations[i]), p3),
+                  "non-dyadic whole-cycle interval ends at p3");
+        }
+    }
+    bezier_curve_t tenth = create_bezier_curve(p0, p1, p2, p3, 0.1f);
+    int tenths = timeline_add_curve(timeline, tenth, 0.2f, 0.5f);
+    check(near(timeline_sample(timeline, tenths, 0.5f), p3), "0.1 s loop over [0.2, 0.5] ends at p3");
+    check(near(timeline_sample(timeline, tenths, 0.35f), vec3_bezier(p0, p1, p2, p3, 0.5f)), "0.1 s loop mid-cycle");
+
+    // Sampling does not depend on the timeline's own clock
+    timeline_advance(timeline, 100.0f);
+    check(near(timeline_sample(timeline, single, 11.0f), vec3_bezier(p0, p1, p2, p3, 0.5f)), "sampling is stateless");
+    free_animation_timeline(timeline);
+}
+
+int main() {
+    random_seed(12345u);
+    test_sparse_active_set();
+    test_boundaries();
+    test_sample();
+
+    return test_report("test_timeline");
+}
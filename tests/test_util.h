@@ -0,0 +1,50 @@
+#ifndef TEST_UTIL_H
+#define TEST_UTIL_H
+
+#include <stdio.h>
+
+// Shared helpers for the self-checking tests. Each test is a single translation
+// unit, so the state below is per test binary.
+
+static int failures = 0;
+
+static inline void check(int condition, const char* what) {
+    if (!condition) {
+        printf("FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+// Prints the summary line for `make test`; returns main's exit code
+static inline int test_report(const char* name) {
+    if (failures) {
+        printf("%s: %d failure(s)\n", name, failures);
+        return 1;
+    }
+    printf("%s: all tests passed\n", name);
+    return 0;
+}
+
+// Deterministic LCG so every run sees the same inputs; each test picks its seed
+static unsigned int test_seed = 1;
+
+static inline void random_seed(unsigned int seed) {
+    test_seed = seed;
+}
+
+static inline unsigned int random_bits(void) {
+    test_seed = test_seed * 1103515245u + 12345u;
+    return test_seed >> 8;
+}
+
+// Uniform in [0, 1)
+static inline float random_unit(void) {
+    return (float)(random_bits() & 0xFFFF) / 65536.0f;
+}
+
+// Uniform integer in [-range, range]
+static inline int random_coord(int range) {
+    return (int)(random_bits() % (unsigned)(2 * range + 1)) - range;
+}
+
+#endif